@@ -27,6 +27,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "ElfWriter.h"
 #include "secure_mem.h" // needed for memcpy_s on linux/android
 #include <cstring>
+#include <vector>
 
 namespace CLElfLib
 {
@@ -51,25 +52,30 @@ CElfWriter::CElfWriter(
 \******************************************************************************/
 CElfWriter::~CElfWriter()
 {
-    SSectionNode* pNode = NULL;
-
     // Walk through the section nodes
     while( m_nodeQueue.empty() == false )
     {
-        pNode = m_nodeQueue.front();
+        DeleteNode( m_nodeQueue.front() );
         m_nodeQueue.pop();
+    }
+}
 
-        // delete the node and it's data
-        if( pNode )
+/******************************************************************************\
+ Member Function: CElfWriter::DeleteNode
+\******************************************************************************/
+void CElfWriter::DeleteNode(
+    SSectionNode* pNode )
+{
+    // delete the node and it's data
+    if( pNode )
+    {
+        if( pNode->OwnsData && pNode->pData )
         {
-            if( pNode->pData )
-            {
-                delete[] pNode->pData;
-                pNode->pData = NULL;
-            }
-
-            delete pNode;
+            delete[] pNode->pData;
+            pNode->pData = NULL;
         }
+
+        delete pNode;
     }
 }
 
@@ -110,6 +116,25 @@ void CElfWriter::Delete(
 \******************************************************************************/
 E_RETVAL CElfWriter::AddSection(
     SSectionNode* pSectionNode )
+{
+    return QueueSection( pSectionNode, true );
+}
+
+/******************************************************************************\
+ Member Function: CElfWriter::AddSectionReference
+\******************************************************************************/
+E_RETVAL CElfWriter::AddSectionReference(
+    SSectionNode* pSectionNode )
+{
+    return QueueSection( pSectionNode, false );
+}
+
+/******************************************************************************\
+ Member Function: CElfWriter::QueueSection
+\******************************************************************************/
+E_RETVAL CElfWriter::QueueSection(
+    SSectionNode* pSectionNode,
+    bool copyData )
 {
     E_RETVAL retVal = SUCCESS;
     SSectionNode* pNode = NULL;
@@ -142,9 +167,15 @@ E_RETVAL CElfWriter::AddSection(
         pNode->Name = pSectionNode->Name;
 
         // ok to have NULL data
-        if( dataSize > 0 )
+        if( dataSize > 0 && !copyData )
+        {
+            pNode->pData = pSectionNode->pData;
+            pNode->DataSize = dataSize;
+        }
+        else if( dataSize > 0 )
         {
             pNode->pData = new char[dataSize];
+            pNode->OwnsData = true;
 
             if( pNode->pData )
             {
@@ -170,17 +201,93 @@ E_RETVAL CElfWriter::AddSection(
         else
         {
             // cleanup allocations
-            if( pNode )
-            {
-                if( pNode->pData )
-                {
-                    delete[] pNode->pData;
-                    pNode->pData = NULL;
-                }
+            DeleteNode( pNode );
+        }
+    }
 
-                delete pNode;
-            }
+    return retVal;
+}
+
+/******************************************************************************\
+ Member Function: CElfWriter::EmitBinary
+ Description:     Lays out the binary and hands it to emit( pData, size ) in
+                  file order: ELF header, section headers, section data and
+                  the string table. Section data is passed straight from the
+                  nodes, so nothing is staged in between. Consumes the queue.
+\******************************************************************************/
+template<typename EmitFn>
+E_RETVAL CElfWriter::EmitBinary(
+    EmitFn emit )
+{
+    E_RETVAL retVal = SUCCESS;
+    SSectionNode* pNode = NULL;
+    SElf64Header elfHeader;
+    std::vector<SElf64SectionHeader> sectionHeaders( m_numSections + 1 ); // +1 to account for string table entry
+    std::string stringTable;
+
+    const size_t dataOffset =
+        sizeof( SElf64Header ) +
+        ( sectionHeaders.size() * sizeof( SElf64SectionHeader ) );
+
+    size_t curDataOffset = dataOffset;
+    std::queue<SSectionNode*> nodeQueue;
+    stringTable.reserve( m_stringTableSize );
+
+    // Fill in the section headers first, the data is emitted after them
+    for( size_t i = 0; i < m_numSections; i++ )
+    {
+        pNode = m_nodeQueue.front();
+        m_nodeQueue.pop();
+        nodeQueue.push( pNode );
+
+        SElf64SectionHeader& sectionHeader = sectionHeaders[i];
+        memset( &sectionHeader, 0, sizeof( SElf64SectionHeader ) );
+        sectionHeader.Type = pNode->Type;
+        sectionHeader.Flags = pNode->Flags;
+        sectionHeader.DataSize = pNode->DataSize;
+        sectionHeader.DataOffset = curDataOffset;
+        sectionHeader.Name = (Elf64_Word)stringTable.size();
+
+        curDataOffset += pNode->DataSize;
+        stringTable.append( pNode->Name.c_str(), pNode->Name.size() + 1 );
+    }
+
+    // add the string table section header
+    SElf64SectionHeader& stringSectionHeader = sectionHeaders.back();
+    memset( &stringSectionHeader, 0, sizeof( SElf64SectionHeader ) );
+    stringSectionHeader.Type = SH_TYPE_STR_TBL;
+    stringSectionHeader.Flags = 0;
+    stringSectionHeader.DataOffset = curDataOffset;
+    stringSectionHeader.DataSize = m_stringTableSize;
+    stringSectionHeader.Name = 0;
+
+    // Add to our section number
+    m_numSections++;
+
+    // patch up the ELF header
+    retVal = PatchElfHeader( (char*)&elfHeader );
+
+    if( retVal == SUCCESS )
+    {
+        emit( (const char*)&elfHeader, sizeof( SElf64Header ) );
+        emit( (const char*)sectionHeaders.data(), sectionHeaders.size() * sizeof( SElf64SectionHeader ) );
+    }
+
+    while( nodeQueue.empty() == false )
+    {
+        pNode = nodeQueue.front();
+        nodeQueue.pop();
+
+        if( retVal == SUCCESS && pNode->DataSize > 0 )
+        {
+            emit( pNode->pData, pNode->DataSize );
         }
+        DeleteNode( pNode );
+    }
+
+    if( retVal == SUCCESS )
+    {
+        emit( stringTable.data(), stringTable.size() );
     }
 
     return retVal;
@@ -194,11 +301,6 @@ E_RETVAL CElfWriter::ResolveBinary(
     size_t& binarySize )
 {
     E_RETVAL retVal = SUCCESS;
-    SSectionNode* pNode = NULL;
-    SElf64SectionHeader* pCurSectionHeader = NULL;
-    char* pData = NULL;
-    char* pStringTable = NULL;
-    char* pCurString = NULL;
 
     m_totalBinarySize = 
         sizeof( SElf64Header ) + 
@@ -208,89 +310,51 @@ E_RETVAL CElfWriter::ResolveBinary(
 
     if( pBinary )
     {
-        // get a pointer to the first section header
-        pCurSectionHeader = (SElf64SectionHeader*)( pBinary + sizeof( SElf64Header ) );
+        char* pCur = pBinary;
+        retVal = EmitBinary( [&]( const char* pData, size_t size )
+        {
+            memcpy_s( pCur, size, pData, size );
+            pCur += size;
+        } );
+    }
 
-        // get a pointer to the data
-        pData = pBinary +
-            sizeof( SElf64Header ) + 
-            ( ( m_numSections + 1 ) * sizeof( SElf64SectionHeader ) ); // +1 to account for string table entry
+    if( retVal == SUCCESS )
+    {
+        binarySize = m_totalBinarySize;
+    }
 
+    return retVal;
+}
 
-        // get a pointer to the string table
-        pStringTable = pBinary + sizeof( SElf64Header ) + 
-            ( ( m_numSections + 1 ) * sizeof( SElf64SectionHeader ) ) + // +1 to account for string table entry
-            m_dataSize ;
+/******************************************************************************\
+ Member Function: CElfWriter::WriteBinary
+\******************************************************************************/
+E_RETVAL CElfWriter::WriteBinary(
+    std::ostream& os,
+    size_t& binarySize )
+{
+    E_RETVAL retVal = SUCCESS;
+    size_t dataSize = 0;
 
-        pCurString = pStringTable;
+    // compute the total size
+    retVal = ResolveBinary( NULL, dataSize );
 
-        // Walk through the section nodes
-        while( m_nodeQueue.empty() == false )
+    if( retVal == SUCCESS )
+    {
+        retVal = EmitBinary( [&]( const char* pData, size_t size )
         {
-            pNode = m_nodeQueue.front();
-
-            if( pNode )
-            {
-                m_nodeQueue.pop();
-
-                // Copy data into the section header
-                memset( pCurSectionHeader, 0, sizeof( SElf64SectionHeader ) );
-                pCurSectionHeader->Type = pNode->Type;
-                pCurSectionHeader->Flags = pNode->Flags;
-                pCurSectionHeader->DataSize = pNode->DataSize;
-                pCurSectionHeader->DataOffset = pData - pBinary;
-                pCurSectionHeader->Name = (Elf64_Word)( pCurString - pStringTable );
-                pCurSectionHeader = (SElf64SectionHeader*)( 
-                    (unsigned char*)pCurSectionHeader + sizeof( SElf64SectionHeader ) );
-
-                // copy the data, move the data pointer
-                memcpy_s( pData, pNode->DataSize, pNode->pData, pNode->DataSize );
-                pData += pNode->DataSize;
-
-                // copy the name into the string table, move the string pointer
-                if ( pNode->Name.size() > 0 )
-                {
-                    memcpy_s( pCurString, pNode->Name.size(), pNode->Name.c_str(), pNode->Name.size() );
-                    pCurString += pNode->Name.size();
-                }
-                *(pCurString++) = '\0';
-
-                // delete the node and it's data
-                if( pNode )
-                {
-                    if( pNode->pData )
-                    {
-                        delete[] pNode->pData;
-                        pNode->pData = NULL;
-                    }
-
-                    delete pNode;
-                }
-            }
-        }
-
-        // add the string table section header
-        SElf64SectionHeader stringSectionHeader = { 0 };
-        stringSectionHeader.Type = SH_TYPE_STR_TBL;
-        stringSectionHeader.Flags = 0;
-        stringSectionHeader.DataOffset = pStringTable - pBinary;
-        stringSectionHeader.DataSize = m_stringTableSize;
-        stringSectionHeader.Name = 0;
-
-        // Copy into the last section header
-        memcpy_s( pCurSectionHeader, sizeof( SElf64SectionHeader ), 
-            &stringSectionHeader, sizeof( SElf64SectionHeader ) );
-
-        // Add to our section number
-        m_numSections++;
+            os.write( pData, size );
+        } );
+    }
 
-        // patch up the ELF header
-        retVal = PatchElfHeader( pBinary );
+    if( retVal == SUCCESS && !os.good() )
+    {
+        retVal = FAILURE;
     }
 
     if( retVal == SUCCESS )
     {
-        binarySize = m_totalBinarySize;
+        binarySize = dataSize;
     }
 
     return retVal;
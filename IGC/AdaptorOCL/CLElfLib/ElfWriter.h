@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "CLElfTypes.h"
 #include <queue>
 #include <string>
+#include <ostream>
 
 #if defined(_WIN32) && (__KLOCWORK__ == 0)
   #define ELF_CALL __stdcall
@@ -50,6 +51,7 @@ struct SSectionNode
     string Name;
     char* pData;
     unsigned int DataSize;
+    bool OwnsData;  // set by the writer on its own nodes; pData is deleted with the node
 
     SSectionNode()
     {
@@ -57,6 +59,7 @@ struct SSectionNode
         Flags    = 0;
         pData    = NULL;
         DataSize = 0;
+        OwnsData = false;
     }
 
     ~SSectionNode()
@@ -86,10 +89,20 @@ public:
     E_RETVAL ELF_CALL AddSection(
         SSectionNode* pSectionNode );
 
+    // Same as AddSection, but the section data is not copied: pSectionNode->pData
+    // must stay valid until ResolveBinary or WriteBinary has emitted it.
+    E_RETVAL ELF_CALL AddSectionReference(
+        SSectionNode* pSectionNode );
+
     E_RETVAL ELF_CALL ResolveBinary( 
         char* const pBinary,
         size_t& dataSize );
 
+    // Streams the binary to os without building it in memory first.
+    E_RETVAL ELF_CALL WriteBinary(
+        std::ostream& os,
+        size_t& dataSize );
+
     E_RETVAL ELF_CALL Initialize();
     E_RETVAL ELF_CALL PatchElfHeader( char* const pBinary );
 
@@ -101,6 +114,15 @@ protected:
 
     ELF_CALL ~CElfWriter();
 
+    E_RETVAL ELF_CALL QueueSection(
+        SSectionNode* pSectionNode,
+        bool copyData );
+
+    template<typename EmitFn>
+    E_RETVAL EmitBinary( EmitFn emit );
+
+    static void DeleteNode( SSectionNode* pNode );
+
     E_EH_TYPE m_type;
     E_EH_MACHINE m_machine;
     Elf64_Xword m_flags;
@@ -61,6 +61,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <algorithm>
 #include <cstring>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 
 using namespace IGC;
 using namespace IGC::IGCMD; 
@@ -224,6 +227,7 @@ struct SStateProcessorContextGen8_0
 };
 CGen8OpenCLStateProcessor::CGen8OpenCLStateProcessor( PLATFORM platform, const IGC::OpenCLProgramContext &context ) :
     m_Context( context ),
+    m_DedupedStateHeapBytes( 0 ),
     m_Platform( platform )
 {
     G6HWC::InitializeCapsGen8( &m_HWCaps );
@@ -889,7 +893,12 @@ RETVAL CGen8OpenCLStateProcessor::CreateDynamicStateHeap(
                 borderColorOffsets[i] = borderColorOffset;
             }
 
-            //  Indirect states for inline samplers:
+            //  Indirect states for inline samplers. Nothing patches these after
+            //  compilation, so inline samplers with the same border color can
+            //  point at a single state. Keyed on the raw state bytes so that
+            //  e.g. -0.0f and 0.0f stay distinct.
+            std::unordered_map<std::string, DWORD> inlineBorderColorOffsets;
+
             for (DWORD i = 0; i < numInlineSamplers && retValue.Success; i++)
             {
                 const SamplerInputAnnotation* samplerAnnotation = annotations.m_samplerInput[i];
@@ -900,8 +909,18 @@ RETVAL CGen8OpenCLStateProcessor::CreateDynamicStateHeap(
                 bcState.BorderColorBlue     = samplerAnnotation->BorderColorB;
                 bcState.BorderColorAlpha    = samplerAnnotation->BorderColorA;
 
+                const std::string key( (const char*)&bcState, sizeof( bcState ) );
+                auto it = inlineBorderColorOffsets.find( key );
+                if( it != inlineBorderColorOffsets.end() )
+                {
+                    borderColorOffsets[i + numArgumentSamplers] = it->second;
+                    m_DedupedStateHeapBytes += sizeof( bcState );
+                    continue;
+                }
+
                 DWORD borderColorOffset = AllocateSamplerIndirectState(bcState, membuf);
                 borderColorOffsets[i + numArgumentSamplers] = borderColorOffset;
+                inlineBorderColorOffsets.emplace( key, borderColorOffset );
             }
         }
         else
@@ -2347,6 +2366,16 @@ RETVAL CGen8OpenCLStateProcessor::CombineKernelBinary(
 
     ICBE_DPF( GFXDBG_HARDWARE, "Kernel Name: %s\n", annotations.m_kernelName.c_str() );
 
+    kernelBinary.Reserve(
+        kernelBinary.Size() +
+        sizeof( header ) +
+        header.KernelNameSize +
+        header.KernelHeapSize +
+        header.GeneralStateHeapSize +
+        header.DynamicStateHeapSize +
+        header.SurfaceStateHeapSize +
+        header.PatchListSize );
+
     kernelBinary.Write( header );
     kernelBinary.Write( annotations.m_kernelName.c_str(), annotations.m_kernelName.size() + 1 );
     kernelBinary.Align( 4 );
@@ -110,6 +110,9 @@ public:
 
     std::string m_oclStateDebugMessagePrintOut;
 
+    // Bytes of state heap not emitted because an identical block was reused.
+    size_t m_DedupedStateHeapBytes;
+
 private:
     const G6HWC::SMediaHardwareCapabilities& HWCaps() const;
 
@@ -85,8 +85,20 @@ RETVAL CGen8OpenCLProgram::GetProgramBinary(
     if (IGC_IS_FLAG_ENABLED(DumpOCLProgramInfo))
     {
         DebugProgramBinaryHeader(&header, m_StateProcessor.m_oclStateDebugMessagePrintOut);
+        ICBE_DPF_STR(m_StateProcessor.m_oclStateDebugMessagePrintOut, GFXDBG_HARDWARE,
+            "State heap bytes saved by deduplication: %u\n",
+            (unsigned)m_StateProcessor.m_DedupedStateHeapBytes);
     }
 
+    // Size the output up front so that it is written without reallocation
+    // and can be handed over with ReleaseBuffer.
+    std::streamsize programBinarySize = sizeof( header ) + m_ProgramScopePatchStream->Size();
+    for( auto i = m_KernelBinaries.begin(); i != m_KernelBinaries.end(); ++i )
+    {
+        programBinarySize += (*i)->Size();
+    }
+    programBinary.Reserve( programBinary.Size() + programBinarySize );
+
     programBinary.Write( header );
 
     programBinary.Write( *m_ProgramScopePatchStream );
@@ -117,6 +129,13 @@ RETVAL CGen8OpenCLProgram::GetProgramDebugData(Util::BinaryStream& programDebugD
         header.SteppingId = m_Platform.usRevId;
 
 
+        std::streamsize programDebugDataSize = sizeof( header );
+        for( auto i = m_KernelDebugDataList.begin(); i != m_KernelDebugDataList.end(); ++i )
+        {
+            programDebugDataSize += (*i)->Size();
+        }
+        programDebugData.Reserve( programDebugData.Size() + programDebugDataSize );
+
         programDebugData.Write( header );
 
         for( auto i = m_KernelDebugDataList.begin(); i != m_KernelDebugDataList.end(); ++i )
@@ -26,67 +26,109 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "BinaryStream.h"
 
+#include <cstring>
+#include <new>
+
 namespace Util
 {
 
-BinaryStream::BinaryStream() : m_membuf( std::ios::in | std::ios::out | std::ios::binary )
+BinaryStream::BinaryStream() : m_pBuffer( nullptr ), m_Size( 0 ), m_Capacity( 0 )
 {
     // Nothing!
 }
 
 BinaryStream::~BinaryStream()
 {
-    // Nothing!
+    delete[] m_pBuffer;
 }
 
-bool BinaryStream::Write( const char* s, std::streamsize n )
+bool BinaryStream::Grow( std::streamsize minCapacity )
 {
-    bool retValue = false;
+    if( minCapacity <= m_Capacity )
+    {
+        return true;
+    }
 
-    std::streamsize prevSize = Size();
+    // Grow geometrically in whole chunks to keep appends amortized O(1)
+    std::streamsize newCapacity = m_Capacity * 2;
+    if( newCapacity < minCapacity )
+    {
+        newCapacity = minCapacity;
+    }
+    newCapacity = ( ( newCapacity + s_ChunkSize - 1 ) / s_ChunkSize ) * s_ChunkSize;
 
-    m_membuf.write( s, n );
+    char* pNewBuffer = new (std::nothrow) char[ (size_t)newCapacity ];
+    if( pNewBuffer == nullptr )
+    {
+        return false;
+    }
 
-    if( ( Size() - prevSize ) == n )
+    if( m_Size )
     {
-        retValue = true;
+        memcpy( pNewBuffer, m_pBuffer, (size_t)m_Size );
     }
+    delete[] m_pBuffer;
 
-    if( m_membuf.fail() )
+    m_pBuffer = pNewBuffer;
+    m_Capacity = newCapacity;
+
+    return true;
+}
+
+bool BinaryStream::Reserve( std::streamsize capacity )
+{
+    if( capacity <= m_Capacity )
     {
-        retValue = false;
+        return true;
+    }
+
+    // Reserve exactly so that a stream sized up front is not over-allocated
+    char* pNewBuffer = new (std::nothrow) char[ (size_t)capacity ];
+    if( pNewBuffer == nullptr )
+    {
+        return false;
     }
 
-#if defined(_DEBUG)
-    GetLinearPointer();
-#endif
+    if( m_Size )
+    {
+        memcpy( pNewBuffer, m_pBuffer, (size_t)m_Size );
+    }
+    delete[] m_pBuffer;
 
-    return retValue;
+    m_pBuffer = pNewBuffer;
+    m_Capacity = capacity;
+
+    return true;
 }
 
-bool BinaryStream::Write( const BinaryStream& in )
+bool BinaryStream::Write( const char* s, std::streamsize n )
 {
-    bool retValue = false;
+    // The source may be this stream's own buffer, which Grow() can free
+    bool isSelf = m_pBuffer != nullptr && s >= m_pBuffer && s < m_pBuffer + m_Size;
+    std::streamsize selfOffset = isSelf ? s - m_pBuffer : 0;
 
-    std::streamsize prevSize = Size();
+    if( n < 0 || !Grow( m_Size + n ) )
+    {
+        return false;
+    }
 
-    m_membuf << in.m_membuf.str();
-    
-    if( ( Size() - prevSize ) == in.Size() )
+    if( isSelf )
     {
-        retValue = true;
+        s = m_pBuffer + selfOffset;
     }
 
-    if( m_membuf.fail() )
+    if( n )
     {
-        retValue = false;
+        memcpy( m_pBuffer + m_Size, s, (size_t)n );
+        m_Size += n;
     }
 
-#if defined(_DEBUG)
-    GetLinearPointer();
-#endif
+    return true;
+}
 
-    return retValue;
+bool BinaryStream::Write( const BinaryStream& in )
+{
+    return Write( in.m_pBuffer, in.m_Size );
 }
 
 
@@ -94,12 +136,10 @@ bool BinaryStream::WriteAt( const char* s, std::streamsize n, std::streamsize lo
 {
     bool retValue = true;
 
-    // Give this function name it seems like this function should enlarge the stream if needed. Discuss.
-    if( ( n + loc ) < Size() )
+    // Back-patching only, the stream is not enlarged.
+    if( loc >= 0 && n >= 0 && ( n + loc ) <= Size() )
     {
-        m_membuf.seekp( loc, std::ios_base::beg );
-        Write( s, n );
-        m_membuf.seekp( 0, std::ios_base::end );
+        memcpy( m_pBuffer + loc, s, (size_t)n );
     }
     else
     {
@@ -109,10 +149,20 @@ bool BinaryStream::WriteAt( const char* s, std::streamsize n, std::streamsize lo
     return retValue;
 }
 
-const char* BinaryStream::GetLinearPointer()
+const char* BinaryStream::GetLinearPointer() const
 {
-    m_LinearPointer = m_membuf.str();
-    return m_LinearPointer.c_str();
+    return m_pBuffer;
+}
+
+char* BinaryStream::ReleaseBuffer()
+{
+    char* pBuffer = m_pBuffer;
+
+    m_pBuffer = nullptr;
+    m_Size = 0;
+    m_Capacity = 0;
+
+    return pBuffer;
 }
 
 bool BinaryStream::Align( std::streamsize alignment )
@@ -137,28 +187,22 @@ bool BinaryStream::Align( std::streamsize alignment )
 
 bool BinaryStream::AddPadding( std::streamsize padding )
 {
-    bool retValue = true;
-
-    while( padding-- )
+    if( padding < 0 || !Grow( m_Size + padding ) )
     {
-        // Always pad with 0x0 to make external tools that parse
-        // OpenCL program binaries easier to maintain
-        retValue &= Write( (char)0x0 );
+        return false;
     }
 
-    return retValue;
-}
+    // Always pad with 0x0 to make external tools that parse
+    // OpenCL program binaries easier to maintain
+    memset( m_pBuffer + m_Size, 0, (size_t)padding );
+    m_Size += padding;
 
-std::streamsize BinaryStream::Size() const
-{
-    // tellp is a non const function
-    // TODO: Is there a better way to do this?
-    return const_cast<BinaryStream*>(this)->Size();
+    return true;
 }
 
-std::streamsize BinaryStream::Size()
+std::streamsize BinaryStream::Size() const
 {
-    return m_membuf.tellp();
+    return m_Size;
 }
 
 }
@@ -26,11 +26,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-#include <sstream>
+#include <ios>
 
 namespace Util
 {
 
+// Growable byte buffer used to build program binaries. Storage is linear so
+// GetLinearPointer does not copy, and is grown in multiples of a chunk size.
+// ReleaseBuffer hands the storage (allocated with new[]) to the caller.
 class BinaryStream
 {
 public:
@@ -52,15 +55,25 @@ public:
     bool Align( std::streamsize alignment );
     bool AddPadding( std::streamsize padding );
 
-    const char* GetLinearPointer();
+    bool Reserve( std::streamsize capacity );
+
+    const char* GetLinearPointer() const;
+
+    char* ReleaseBuffer();
     
     std::streamsize Size() const;
-    std::streamsize Size();
 
 private:
-    std::stringstream m_membuf;
+    BinaryStream( const BinaryStream& ) = delete;
+    BinaryStream& operator=( const BinaryStream& ) = delete;
+
+    bool Grow( std::streamsize minCapacity );
+
+    static const std::streamsize s_ChunkSize = 4096;
 
-    std::string m_LinearPointer;
+    char*           m_pBuffer;
+    std::streamsize m_Size;
+    std::streamsize m_Capacity;
 };
 
 template< class T >
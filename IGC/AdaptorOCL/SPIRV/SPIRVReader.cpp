@@ -66,6 +66,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "libSPIRV/SPIRVInstruction.h"
 #include "SPIRVInternal.h"
 #include "common/MDFrameWork.h"
+#include "common/igc_regkeys.hpp"
 #include "../../AdaptorCommon/TypesLegalizationPass.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/LegacyPassManager.h>
@@ -76,6 +77,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <iterator>
 
 using namespace llvm;
 
@@ -1190,7 +1193,7 @@ SPIRVToLLVM::transLinkageType(const SPIRVValue* V) {
   else if (V->getLinkageType() == LinkageTypeImport) {
     // Function declaration
     if (V->getOpCode() == OpFunction) {
-      if (static_cast<const SPIRVFunction*>(V)->getNumBasicBlock() == 0)
+      if (!static_cast<const SPIRVFunction*>(V)->hasBody())
         return GlobalValue::ExternalLinkage;
     }
     // Variable declaration
@@ -2600,6 +2603,9 @@ SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
         SPIRSPIRVFuncParamAttrMap::rmap(Kind));
   });
 
+  // Bodies read in lazy mode are decoded right before they are translated.
+  BF->materialize();
+
   // Creating all basic blocks before creating instructions.
   for (size_t I = 0, E = BF->getNumBasicBlock(); I != E; ++I) {
     transValue(BF->getBasicBlock(I), F, nullptr, true, BoolAction::Noop);
@@ -3467,13 +3473,21 @@ static void dumpSPIRVBC(const char* fname, const char* data, unsigned int size)
     }
 }
 
-bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
+bool ReadSPIRV(LLVMContext &C, const uint32_t *Words, size_t NumWords,
+    Module *&M,
     StringRef options,
     std::string &ErrMsg) {
 
   std::unique_ptr<SPIRVModule> BM( SPIRVModule::createSPIRVModule() );
   BM->setCompileFlag( options );
+  // Deferred bodies are decoded from Words, which outlives the translation.
+  BM->setLazyFunctionBodies(IGC_IS_FLAG_ENABLED(EnableSPIRVLazyFunctionBodies));
+  SPIRVInputStream IS( Words, NumWords );
   IS >> *BM;
+  if (BM->getError(ErrMsg) != SPIRVEC_Success) {
+    M = nullptr;
+    return false;
+  }
   BM->resolveUnknownStructFields();
   M = new Module( "",C );
   SPIRVToLLVM BTL( M,BM.get() );
@@ -3498,4 +3512,27 @@ bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
   return Succeed;
 }
 
+bool ReadSPIRV(LLVMContext &C, StringRef Binary, Module *&M,
+    StringRef options,
+    std::string &ErrMsg) {
+  size_t NumWords = Binary.size() / sizeof(SPIRVWord);
+  if (reinterpret_cast<uintptr_t>(Binary.data()) % alignof(SPIRVWord) == 0) {
+    return ReadSPIRV(C, reinterpret_cast<const SPIRVWord*>(Binary.data()),
+        NumWords, M, options, ErrMsg);
+  }
+
+  std::vector<SPIRVWord> Words(NumWords);
+  memcpy(Words.data(), Binary.data(), NumWords * sizeof(SPIRVWord));
+  return ReadSPIRV(C, Words.data(), NumWords, M, options, ErrMsg);
+}
+
+bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
+    StringRef options,
+    std::string &ErrMsg) {
+  std::vector<char> Binary((std::istreambuf_iterator<char>(IS)),
+      std::istreambuf_iterator<char>());
+  return ReadSPIRV(C, StringRef(Binary.data(), Binary.size()), M, options,
+      ErrMsg);
+}
+
 }
@@ -40,7 +40,23 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "llvm/IR/Module.h"
 
+#include <cstdint>
+
 namespace spv{
+// Loads SPIRV from a buffer of words and translate to LLVM module.
+// The words are decoded in place without being copied.
+// Returns true if succeeds.
+bool ReadSPIRV(llvm::LLVMContext &C, const uint32_t *Words, size_t NumWords,
+    llvm::Module *&M,
+    llvm::StringRef options,
+    std::string &ErrMsg);
+
+// Loads SPIRV from a byte buffer. The buffer is only copied if it is not
+// suitably aligned to be read as words.
+bool ReadSPIRV(llvm::LLVMContext &C, llvm::StringRef Binary, llvm::Module *&M,
+    llvm::StringRef options,
+    std::string &ErrMsg);
+
 // Loads SPIRV from istream and translate to LLVM module.
 // Returns true if succeeds.
 bool ReadSPIRV(llvm::LLVMContext &C, std::istream &IS, llvm::Module *&M,
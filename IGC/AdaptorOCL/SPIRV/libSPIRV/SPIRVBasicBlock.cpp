@@ -76,7 +76,7 @@ SPIRVBasicBlock::SPIRVBasicBlock(SPIRVId TheId, SPIRVFunction *Func)
 }
 
 SPIRVDecoder
-SPIRVBasicBlock::getDecoder(std::istream &IS){
+SPIRVBasicBlock::getDecoder(SPIRVInputStream &IS){
   return SPIRVDecoder(IS, *this);
 }
 
@@ -82,7 +82,7 @@ public:
     setAttr();
   }
 
-  SPIRVDecoder getDecoder(std::istream &IS);
+  SPIRVDecoder getDecoder(SPIRVInputStream &IS);
   SPIRVFunction *getParent() const { return ParentF;}
   size_t getNumInst() const { return InstVec.size();}
   SPIRVInstruction *getInst(size_t I) const { return InstVec[I];}
@@ -110,10 +110,9 @@ SPIRVDecorate::setWordCount(SPIRVWord Count){
 }
 
 void
-SPIRVDecorate::decode(std::istream &I)
+SPIRVDecorate::decode(SPIRVInputStream &I)
 {
     getDecoder(I) >> Target >> Dec;
-    auto currLoc = I.tellg();
 
     getDecoder(I) >> Literals;
 
@@ -121,9 +120,10 @@ SPIRVDecorate::decode(std::istream &I)
 
     if (Dec == DecorationLinkageAttributes)
     {
-        I.seekg(currLoc);
+        // The linkage name is the string at the start of the literals.
+        SPIRVInputStream LiteralStream(Literals.data(), Literals.size());
         std::string funcName;
-        getDecoder(I) >> funcName;
+        getDecoder(LiteralStream) >> funcName;
         target->setName(funcName);
     }
 
@@ -137,19 +137,19 @@ SPIRVMemberDecorate::setWordCount(SPIRVWord Count){
 }
 
 void
-SPIRVMemberDecorate::decode(std::istream &I){
+SPIRVMemberDecorate::decode(SPIRVInputStream &I){
   getDecoder(I) >> Target >> MemberNumber >> Dec >> Literals;
   getOrCreateTarget()->addMemberDecorate(this);
 }
 
 void
-SPIRVDecorationGroup::decode(std::istream &I){
+SPIRVDecorationGroup::decode(SPIRVInputStream &I){
   getDecoder(I) >> Id;
   Module->addDecorationGroup(this);
 }
 
 void
-SPIRVGroupDecorateGeneric::decode(std::istream &I){
+SPIRVGroupDecorateGeneric::decode(SPIRVInputStream &I){
   getDecoder(I) >> DecorationGroup >> Targets;
   Module->addGroupDecorateGeneric(this);
 }
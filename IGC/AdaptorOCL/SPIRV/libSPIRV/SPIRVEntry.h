@@ -80,6 +80,7 @@ namespace spv{
 
 class SPIRVModule;
 class SPIRVDecoder;
+class SPIRVInputStream;
 class SPIRVType;
 class SPIRVValue;
 class SPIRVDecorate;
@@ -92,56 +93,56 @@ class SPIRVExtInst;
 // Add declaration of decode functions to a class.
 // Used inside class definition.
 #define _SPIRV_DCL_DEC \
-    void decode(std::istream &I);
+    void decode(SPIRVInputStream &I);
 
 // Add implementation of decode functions to a class.
 // Used out side of class definition.
 #define _SPIRV_IMP_DEC0(Ty)                                                              \
-    void Ty::decode(std::istream &I) {}
+    void Ty::decode(SPIRVInputStream &I) {}
 #define _SPIRV_IMP_DEC1(Ty,x)                                                            \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x;}
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x;}
 #define _SPIRV_IMP_DEC2(Ty,x,y)                                                          \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x >> y;}
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y;}
 #define _SPIRV_IMP_DEC3(Ty,x,y,z)                                                        \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x >> y >> z;}
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z;}
 #define _SPIRV_IMP_DEC4(Ty,x,y,z,u)                                                      \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u;}
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u;}
 #define _SPIRV_IMP_DEC5(Ty,x,y,z,u,v)                                                    \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >> v;}           
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >> v;}           
 #define _SPIRV_IMP_DEC6(Ty,x,y,z,u,v,w)                                                  \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >> v >> w;}
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >> v >> w;}
 #define _SPIRV_IMP_DEC7(Ty,x,y,z,u,v,w,r)                                                \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >> v >> w >> r;}
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >> v >> w >> r;}
 #define _SPIRV_IMP_DEC8(Ty,x,y,z,u,v,w,r,s)                                              \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >>              \
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >>           \
       v >> w >> r >> s;}
 #define _SPIRV_IMP_DEC9(Ty,x,y,z,u,v,w,r,s,t)                                            \
-    void Ty::decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >>              \
+    void Ty::decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >>           \
       v >> w >> r >> s >> t;}
 
 // Add definition of decode functions to a class.
 // Used inside class definition.
 #define _SPIRV_DEF_DEC0                                                                  \
-    void decode(std::istream &I) {}
+    void decode(SPIRVInputStream &I) {}
 #define _SPIRV_DEF_DEC1(x)                                                               \
-    void decode(std::istream &I) { getDecoder(I) >> x;}
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x;}
 #define _SPIRV_DEF_DEC2(x,y)                                                             \
-    void decode(std::istream &I) { getDecoder(I) >> x >> y;}
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y;}
 #define _SPIRV_DEF_DEC3(x,y,z)                                                           \
-    void decode(std::istream &I) { getDecoder(I) >> x >> y >> z;}
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z;}
 #define _SPIRV_DEF_DEC4(x,y,z,u)                                                         \
-    void decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u;}
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u;}
 #define _SPIRV_DEF_DEC5(x,y,z,u,v)                                                       \
-    void decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >> v;}
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >> v;}
 #define _SPIRV_DEF_DEC6(x,y,z,u,v,w)                                                     \
-    void decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >> v >> w;}
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >> v >> w;}
 #define _SPIRV_DEF_DEC7(x,y,z,u,v,w,r)                                                   \
-    void decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >> v >> w >> r;}
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >> v >> w >> r;}
 #define _SPIRV_DEF_DEC8(x,y,z,u,v,w,r,s)                                                 \
-    void decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >> v >>             \
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >> v >>          \
       w >> r >> s;}
 #define _SPIRV_DEF_DEC9(x,y,z,u,v,w,r,s,t)                                               \
-    void decode(std::istream &I) { getDecoder(I) >> x >> y >> z >> u >> v >>             \
+    void decode(SPIRVInputStream &I) { getDecoder(I) >> x >> y >> z >> u >> v >>          \
       w >> r >> s >> t;}
 
 /// All SPIR-V in-memory-representation entities inherits from SPIRVEntry.
@@ -157,7 +158,7 @@ class SPIRVExtInst;
 ///    It is usually called by SPIRVEntry::make(opcode) to create an incomplete
 ///    object which should not be validated. Then setWordCount(count) is
 ///    called to fix the size of the object if it is variable, and then the
-///    information is filled by the virtual function decode(istream).
+///    information is filled by the virtual function decode(SPIRVInputStream).
 ///    After that the object can be validated.
 ///
 /// To add a new SPIRV class:
@@ -222,7 +223,7 @@ public:
   SPIRVType *getValueType(SPIRVId TheId)const;
   std::vector<SPIRVType *> getValueTypes(const std::vector<SPIRVId>&)const;
 
-  virtual SPIRVDecoder getDecoder(std::istream &);
+  virtual SPIRVDecoder getDecoder(SPIRVInputStream &);
   SPIRVErrorLog &getErrorLog()const;
   SPIRVId getId() const { assert(hasId()); return Id;}
   SPIRVLine *getLine() const { return Line;}
@@ -282,8 +283,8 @@ public:
   /// SPIRVTypeInt.
   static SPIRVEntry *create(Op);
 
-  friend std::istream &operator>>(std::istream &I, SPIRVEntry &E);
-  virtual void decode(std::istream &I);
+  friend SPIRVInputStream &operator>>(SPIRVInputStream &I, SPIRVEntry &E);
+  virtual void decode(SPIRVInputStream &I);
 
   friend class SPIRVDecoder;
 
@@ -5,3 +5,4 @@ _SPIRV_OP(InvalidAddressingModel, "Expects 0-2.")
 _SPIRV_OP(InvalidMemoryModel, "Expects 0-3.")
 _SPIRV_OP(InvalidFunctionControlMask,"")
 _SPIRV_OP(InvalidBuiltinSetName, "Expects OpenCL12, OpenCL20.")
+_SPIRV_OP(InvalidModule, "Malformed SPIR-V module.")
@@ -91,12 +91,12 @@ SPIRVFunctionParameter::foreachAttr(
 }
 
 SPIRVDecoder
-SPIRVFunction::getDecoder(std::istream &IS) {
+SPIRVFunction::getDecoder(SPIRVInputStream &IS) {
   return SPIRVDecoder(IS, *this);
 }
 
 void
-SPIRVFunction::decode(std::istream &I) {
+SPIRVFunction::decode(SPIRVInputStream &I) {
   SPIRVDecoder Decoder = getDecoder(I);
   Decoder >> Type >> Id >> FCtrlMask >> FuncType;
   Module->addFunction(this);
@@ -106,6 +106,11 @@ SPIRVFunction::decode(std::istream &I) {
     if (Decoder.OpCode == OpFunctionEnd)
       break;
 
+    if (Decoder.OpCode == OpLabel && Module->isLazyFunctionBodies()) {
+      skipBody(Decoder);
+      break;
+    }
+
     switch(Decoder.OpCode) {
     case OpFunctionParameter: {
       auto Param = static_cast<SPIRVFunctionParameter *>(Decoder.getEntry());
@@ -130,6 +135,64 @@ SPIRVFunction::decode(std::istream &I) {
   }
 }
 
+/// Record the extent of the body and step over it without creating any
+/// entries. Only the word count and opcode of each instruction are looked at.
+///
+/// Names and decorations may appear inside a body and target any id. They
+/// have to be seen before the module's decorations are grouped at the end of
+/// reading and before anything is translated, so a body containing one is
+/// decoded right away instead of being deferred.
+void
+SPIRVFunction::skipBody(SPIRVDecoder &Decoder) {
+  SPIRVInputStream &I = Decoder.IS;
+  LazyBodyBegin = I.getPos() - 1;
+  bool HasAnnotations = false;
+  do {
+    switch (Decoder.OpCode) {
+    case OpLine:
+      Module->setHasDeferredDebugInfo();
+      break;
+    case OpName:
+    case OpMemberName:
+    case OpDecorate:
+    case OpMemberDecorate:
+    case OpDecorationGroup:
+    case OpGroupDecorate:
+    case OpGroupMemberDecorate:
+      HasAnnotations = true;
+      break;
+    default:
+      break;
+    }
+    if (Decoder.WordCount == 0) {
+      spirv_fatal_error("Invalid word count");
+    }
+    I.skip(Decoder.WordCount - 1);
+  } while (Decoder.getWordCountAndOpCode() &&
+           Decoder.OpCode != OpFunctionEnd);
+  LazyBodyEnd = Decoder.OpCode == OpFunctionEnd ? I.getPos() - 1 : I.getPos();
+
+  if (HasAnnotations)
+    materialize();
+}
+
+/// Decode a body skipped by skipBody. The words are still owned by the
+/// caller of the module reader and must be alive at this point.
+void
+SPIRVFunction::materialize() {
+  if (isMaterialized())
+    return;
+
+  SPIRVInputStream I(LazyBodyBegin, LazyBodyEnd - LazyBodyBegin);
+  LazyBodyBegin = LazyBodyEnd = nullptr;
+
+  SPIRVDecoder Decoder = getDecoder(I);
+  Decoder.getWordCountAndOpCode();
+  while (Decoder.OpCode == OpLabel)
+    decodeBB(Decoder);
+  spirv_assert(I.eof() && !I.fail() && "Invalid SPIRV format");
+}
+
 /// Decode basic block and contained instructions.
 /// Do it here instead of in BB:decode to avoid back track in input stream.
 void
@@ -115,20 +115,26 @@ public:
   // Complete constructor. It does not construct basic blocks.
   SPIRVFunction(SPIRVModule *M, SPIRVTypeFunction *FunctionType, SPIRVId TheId)
     :SPIRVValue(M, 5, OpFunction, FunctionType->getReturnType(), TheId),
-    FuncType(FunctionType), FCtrlMask(SPIRVFunctionControlMaskKind::FunctionControlMaskNone) {
+    FuncType(FunctionType), FCtrlMask(SPIRVFunctionControlMaskKind::FunctionControlMaskNone),
+    LazyBodyBegin(nullptr), LazyBodyEnd(nullptr) {
     addAllArguments(TheId + 1);
     validate();
   }
 
   // Incomplete constructor
   SPIRVFunction():SPIRVValue(OpFunction),FuncType(NULL),
-     FCtrlMask(SPIRVFunctionControlMaskKind::FunctionControlMaskNone){}
+     FCtrlMask(SPIRVFunctionControlMaskKind::FunctionControlMaskNone),
+     LazyBodyBegin(nullptr), LazyBodyEnd(nullptr){}
 
-  SPIRVDecoder getDecoder(std::istream &IS);
+  SPIRVDecoder getDecoder(SPIRVInputStream &IS);
   SPIRVTypeFunction *getFunctionType() const { return FuncType;}
   SPIRVWord getFuncCtlMask() const { return FCtrlMask;}
   size_t getNumBasicBlock() const { return BBVec.size();}
   SPIRVBasicBlock *getBasicBlock(size_t i) const { return BBVec[i];}
+  // A function read in lazy mode has a body that has not been decoded yet.
+  bool hasBody() const { return !BBVec.empty() || LazyBodyBegin;}
+  bool isMaterialized() const { return LazyBodyBegin == nullptr;}
+  void materialize();
   size_t getNumArguments() const {
     return getFunctionType()->getNumParameters();
   }
@@ -180,6 +186,7 @@ private:
       addArgument(i, FirstArgId + i);
   }
   void decodeBB(SPIRVDecoder &);
+  void skipBody(SPIRVDecoder &);
 
   SPIRVTypeFunction *FuncType;                  // Function type
   SPIRVWord FCtrlMask;                          // Function control mask
@@ -187,6 +194,11 @@ private:
   std::vector<SPIRVFunctionParameter *> Parameters;
   typedef std::vector<SPIRVBasicBlock *> SPIRVLBasicBlockVector;
   SPIRVLBasicBlockVector BBVec;
+
+  // Words of a body that has been skipped in lazy mode, from the first
+  // OpLabel up to but excluding OpFunctionEnd.
+  const SPIRVWord *LazyBodyBegin;
+  const SPIRVWord *LazyBodyEnd;
 };
 
 typedef SPIRVEntryOpCodeOnly<OpFunctionEnd> SPIRVFunctionEnd;
@@ -368,7 +368,7 @@ public:
   }
 
 protected:
-  virtual void decode(std::istream &I) {
+  virtual void decode(SPIRVInputStream &I) {
     auto D = getDecoder(I);
     if (hasType())
       D >> Type;
@@ -504,7 +504,7 @@ protected:
     MemoryAccess.resize(TheWordCount - FixedWords);
   }
 
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> PtrId >> ValId >> MemoryAccess;
     MemoryAccessUpdate(MemoryAccess);
   }
@@ -553,7 +553,7 @@ protected:
     MemoryAccess.resize(TheWordCount - FixedWords);
   }
 
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Type >> Id >> PtrId >> MemoryAccess;
     MemoryAccessUpdate(MemoryAccess);
   }
@@ -1111,7 +1111,7 @@ public:
         ExtSetKind == SPIRVEIS_DebugInfo) && 
         "not supported");
   }
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Type >> Id >> ExtSetId;
     setExtSetKindById();
     switch(ExtSetKind) {
@@ -1295,7 +1295,7 @@ protected:
     MemoryAccess.resize(TheWordCount - FixedWords);
   }
 
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Target >> Source >> MemoryAccess;
     MemoryAccessUpdate(MemoryAccess);
   }
@@ -1334,7 +1334,7 @@ protected:
     MemoryAccess.resize(TheWordCount - FixedWords);
   }
 
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Target >> Source >> Size >> MemoryAccess;
     MemoryAccessUpdate(MemoryAccess);
   }
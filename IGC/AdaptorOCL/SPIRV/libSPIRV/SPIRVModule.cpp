@@ -87,7 +87,8 @@ public:
     InstSchema(SPIRVISCH_Default),
     SrcLang(SpvSourceLanguageOpenCL_C),
     SrcLangVer(12),
-    MemoryModel(SPIRVMemoryModelKind::MemoryModelOpenCL){
+    MemoryModel(SPIRVMemoryModelKind::MemoryModelOpenCL),
+    LazyFunctionBodies(false), HasDeferredDebugInfo(false){
     AddrModel = sizeof(size_t) == 32 ? AddressingModelPhysical32 : AddressingModelPhysical64;
   };
   virtual ~SPIRVModuleImpl();
@@ -100,7 +101,10 @@ public:
   virtual void addUnknownStructField(
     SPIRVTypeStruct*, unsigned idx, SPIRVId id);
   virtual void resolveUnknownStructFields();
-  bool hasDebugInfo() const { return !LineVec.empty();}
+  bool hasDebugInfo() const { return !LineVec.empty() || HasDeferredDebugInfo;}
+  void setHasDeferredDebugInfo() { HasDeferredDebugInfo = true;}
+  bool isLazyFunctionBodies() const { return LazyFunctionBodies;}
+  void setLazyFunctionBodies(bool Lazy) { LazyFunctionBodies = Lazy;}
 
   // Error handling functions
   SPIRVErrorLog &getErrorLog() { return ErrLog;}
@@ -206,11 +210,11 @@ public:
 
   virtual SPIRVExtInst* getCompilationUnit()
   {
-      for (auto& item : IdEntryMap)
+      for (auto item : IdEntryTable)
       {
-          if (item.second->getOpCode() == spv::Op::OpExtInst)
+          if (item && item->getOpCode() == spv::Op::OpExtInst)
           {
-              auto extInst = static_cast<SPIRVExtInst*>(item.second);
+              auto extInst = static_cast<SPIRVExtInst*>(item);
               if (extInst->getExtSetKind() == SPIRVExtInstSetKind::SPIRVEIS_DebugInfo &&
                   extInst->getExtOp() == OCLExtOpDbgKind::CompileUnit)
                   return extInst;
@@ -224,11 +228,11 @@ public:
   {
       std::vector<SPIRVExtInst*> globalVars;
 
-      for (auto& item : IdEntryMap)
+      for (auto item : IdEntryTable)
       {
-          if (item.second->getOpCode() == spv::Op::OpExtInst)
+          if (item && item->getOpCode() == spv::Op::OpExtInst)
           {
-              auto extInst = static_cast<SPIRVExtInst*>(item.second);
+              auto extInst = static_cast<SPIRVExtInst*>(item);
               if (extInst->getExtSetKind() == SPIRVExtInstSetKind::SPIRVEIS_DebugInfo &&
                   extInst->getExtOp() == OCLExtOpDbgKind::GlobalVariable)
                   globalVars.push_back(extInst);
@@ -239,7 +243,7 @@ public:
   }
 
   // I/O functions
-  friend std::istream & operator>>(std::istream &I, SPIRVModule& M);
+  friend SPIRVInputStream &operator>>(SPIRVInputStream &I, SPIRVModule& M);
 
 private:
   SPIRVErrorLog ErrLog;
@@ -255,8 +259,12 @@ private:
   SPIRVAddressingModelKind AddrModel;
   SPIRVMemoryModelKind MemoryModel;
   std::string ModuleProcessed;
+  bool LazyFunctionBodies;
+  bool HasDeferredDebugInfo;
 
-  typedef std::map<SPIRVId, SPIRVEntry *> SPIRVIdToEntryMap;
+  // SPIR-V ids are dense and bounded by the module header, so entries are
+  // looked up by indexing a table with the id. Unused ids map to null.
+  typedef std::vector<SPIRVEntry *> SPIRVIdToEntryTable;
   typedef std::map<SPIRVTypeStruct*,
       std::vector<std::pair<unsigned, SPIRVId> > > SPIRVUnknownStructFieldMap;
   typedef std::unordered_set<SPIRVEntry *> SPIRVEntrySet;
@@ -273,7 +281,7 @@ private:
   typedef std::map<SPIRVExecutionModelKind, SPIRVIdVec> SPIRVExecModelIdVecMap;
   typedef std::unordered_map<std::string, SPIRVString*> SPIRVStringMap;
 
-  SPIRVIdToEntryMap IdEntryMap;
+  SPIRVIdToEntryTable IdEntryTable;
   SPIRVUnknownStructFieldMap UnknownStructFieldMap;
   SPIRVFunctionVector FuncVec;
   SPIRVVariableVec VariableVec;
@@ -293,11 +301,13 @@ private:
   std::map<unsigned, SPIRVConstant*> LiteralMap;
 
   void layoutEntry(SPIRVEntry* Entry);
+  bool mapId(SPIRVId Id, SPIRVEntry *Entry);
+  void setIdBound(SPIRVId Bound, size_t MaxIds);
 };
 
 SPIRVModuleImpl::~SPIRVModuleImpl() {
-    for (auto I : IdEntryMap)
-        delete I.second;
+    for (auto I : IdEntryTable)
+        delete I;
 
     for (auto I : EntryNoId)
         delete I;
@@ -404,9 +414,11 @@ SPIRVModuleImpl::addEntry(SPIRVEntry *Entry) {
                 assert(Mapped == Entry && "Id used twice");
             }
         }
-        else
+        else if (!mapId(Id, Entry))
         {
-            IdEntryMap[Id] = Entry;
+            // Keep the rejected entry owned so it is freed with the module
+            EntryNoId.insert(Entry);
+            return Entry;
         }
     }
     else
@@ -428,14 +440,37 @@ SPIRVModuleImpl::exist(SPIRVId Id) const {
 bool
 SPIRVModuleImpl::exist(SPIRVId Id, SPIRVEntry **Entry) const {
   assert (Id != SPIRVID_INVALID && "Invalid Id");
-  SPIRVIdToEntryMap::const_iterator Loc = IdEntryMap.find(Id);
-  if (Loc == IdEntryMap.end())
+  if (Id >= IdEntryTable.size() || !IdEntryTable[Id])
     return false;
   if (Entry)
-    *Entry = Loc->second;
+    *Entry = IdEntryTable[Id];
   return true;
 }
 
+// Every valid id is below NextId: the header bound when the module is read,
+// plus any id handed out by getId() afterwards. Ids may be sparse, so the
+// table grows on demand up to the id being mapped.
+bool
+SPIRVModuleImpl::mapId(SPIRVId Id, SPIRVEntry *Entry) {
+  if (Id >= NextId) {
+    // Not checkError: it asserts on failure, and this comes from the input
+    ErrLog.setError(SPIRVEC_InvalidModule, "Id exceeds the module id bound");
+    return false;
+  }
+  if (Id >= IdEntryTable.size())
+    IdEntryTable.resize(Id + 1, nullptr);
+  IdEntryTable[Id] = Entry;
+  return true;
+}
+
+// The bound says nothing about how many ids are used, so only as many
+// entries as the module has words are reserved up front.
+void
+SPIRVModuleImpl::setIdBound(SPIRVId Bound, size_t MaxIds) {
+  NextId = Bound;
+  IdEntryTable.reserve(std::min<size_t>(Bound, MaxIds));
+}
+
 // If Id is invalid, returns the next available id.
 // Otherwise returns the given id and adjust the next available id by increment.
 SPIRVId
@@ -451,9 +486,9 @@ SPIRVModuleImpl::getId(SPIRVId Id, unsigned increment) {
 SPIRVEntry *
 SPIRVModuleImpl::getEntry(SPIRVId Id) const {
   assert (Id != SPIRVID_INVALID && "Invalid Id");
-  SPIRVIdToEntryMap::const_iterator Loc = IdEntryMap.find(Id);
-  spirv_assert (Loc != IdEntryMap.end() && "Id is not in map");
-  return Loc->second;
+  spirv_assert (Id < IdEntryTable.size() && IdEntryTable[Id] &&
+      "Id is not in map");
+  return IdEntryTable[Id];
 }
 
 void
@@ -604,13 +639,12 @@ SPIRVModuleImpl::replaceForward(SPIRVForward *Forward, SPIRVEntry *Entry) {
   SPIRVId Id = Entry->getId();
   SPIRVId ForwardId = Forward->getId();
   if (ForwardId == Id)
-    IdEntryMap[Id] = Entry;
+    IdEntryTable[Id] = Entry;
   else {
-    auto Loc = IdEntryMap.find(Id);
-    spirv_assert(Loc != IdEntryMap.end());
-    IdEntryMap.erase(Loc);
+    spirv_assert(Id < IdEntryTable.size() && IdEntryTable[Id]);
+    IdEntryTable[Id] = nullptr;
     Entry->setId(ForwardId);
-    IdEntryMap[ForwardId] = Entry;
+    mapId(ForwardId, Entry);
   }
   // Annotations include name, decorations, execution modes
   Entry->takeAnnotations(Forward);
@@ -706,8 +740,8 @@ SPIRVModuleImpl::addMemberName(SPIRVTypeStruct* ST,
   return add(new SPIRVMemberName(ST, MemberNumber, Name));
 }
 
-std::istream &
-operator>> (std::istream &I, SPIRVModule &M) {
+SPIRVInputStream &
+operator>> (SPIRVInputStream &I, SPIRVModule &M) {
   SPIRVDecoder Decoder(I, M);
   SPIRVModuleImpl &MI = *static_cast<SPIRVModuleImpl*>(&M);
 
@@ -731,13 +765,17 @@ operator>> (std::istream &I, SPIRVModule &M) {
 
   Decoder >> MI.SPIRVGenerator;
 
-  // Bound for Id
-  Decoder >> MI.NextId;
+  // Bound for Id. Ids at or above it are rejected when they are mapped.
+  SPIRVId Bound = 0;
+  Decoder >> Bound;
+  MI.setIdBound(Bound, I.remaining());
 
   Decoder >> MI.InstSchema;
   assert(MI.InstSchema == SPIRVISCH_Default && "Unsupported instruction schema");
 
-  while(Decoder.getWordCountAndOpCode())
+  std::string ErrMsg;
+  while(MI.getError(ErrMsg) == SPIRVEC_Success &&
+        Decoder.getWordCountAndOpCode())
     Decoder.getEntry();
 
   MI.optimizeDecorates();
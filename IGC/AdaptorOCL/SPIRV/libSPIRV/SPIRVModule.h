@@ -130,6 +130,13 @@ public:
       SPIRVTypeStruct*, unsigned idx, SPIRVId id) = 0;
   virtual void resolveUnknownStructFields() = 0;
   virtual bool hasDebugInfo() const = 0;
+  virtual void setHasDeferredDebugInfo() = 0;
+
+  // Lazy function body decoding. When enabled, function bodies are only
+  // scanned while the module is read and are decoded on demand by
+  // SPIRVFunction::materialize().
+  virtual bool isLazyFunctionBodies() const = 0;
+  virtual void setLazyFunctionBodies(bool Lazy) = 0;
 
   // Error handling functions
   virtual SPIRVErrorLog &getErrorLog() = 0;
@@ -211,7 +218,7 @@ public:
   virtual std::vector<SPIRVExtInst*> getGlobalVars() = 0;
 
   // I/O functions
-  friend std::istream & operator>>(std::istream &I, SPIRVModule& M);
+  friend SPIRVInputStream &operator>>(SPIRVInputStream &I, SPIRVModule& M);
 };
 
 class SPIRVDbgInfo {
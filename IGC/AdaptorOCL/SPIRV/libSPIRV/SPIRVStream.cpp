@@ -70,11 +70,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace spv{
 
-SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVFunction &F)
+SPIRVDecoder::SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVFunction &F)
   :IS(InputStream), M(*F.getModule()), WordCount(0), OpCode(OpNop),
    Scope(&F){}
 
-SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVBasicBlock &BB)
+SPIRVDecoder::SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVBasicBlock &BB)
   :IS(InputStream), M(*BB.getModule()), WordCount(0), OpCode(OpNop),
    Scope(&BB){}
 
@@ -87,8 +87,7 @@ SPIRVDecoder::setScope(SPIRVEntry *TheScope) {
 
 template<>
 const SPIRVDecoder& DecodeBinary(const SPIRVDecoder& I, bool &V) {
-   SPIRVWord W;
-   I.IS.read(reinterpret_cast<char*>(&W), sizeof(W));
+   SPIRVWord W = I.IS.read();
    V = (W == 0) ? false : true;
    return I;
 }
@@ -96,7 +95,7 @@ const SPIRVDecoder& DecodeBinary(const SPIRVDecoder& I, bool &V) {
 template<>
 const SPIRVDecoder&
 DecodeBinary(const SPIRVDecoder& I, SPIRVWord &V) {
-   I.IS.read(reinterpret_cast<char*>(&V), sizeof(V));
+   V = I.IS.read();
    return I;
 }
 
@@ -148,21 +147,20 @@ SPIRV_DEF_DEC(OCLExtOpDbgKind)
 #undef SPIRV_DEF_DEC
 
 // Read a string with padded 0's at the end so that they form a stream of
-// words.
+// words. The terminating 0 is always within the last word of the string, so
+// the string is copied straight out of the buffer and the stream advanced
+// past that word.
 const SPIRVDecoder&
 operator>>(const SPIRVDecoder&I, std::string& Str) {
-  uint64_t Count = 0;
-  char Ch;
-  while ((!I.IS.eof() && I.IS.get(Ch)) && Ch != '\0') {
-    Str += Ch;
-    ++Count;
-  }
-  Count = (Count + 1) % 4;
-  Count = Count ? 4 - Count : 0;
-  for (;Count; --Count) {
-    (!I.IS.eof() && I.IS.get(Ch));
-    assert(Ch == '\0' && "Invalid string in SPIRV");
-  }
+  const char *Chars = reinterpret_cast<const char*>(I.IS.getPos());
+  const char *CharsEnd = Chars + I.IS.remaining() * sizeof(SPIRVWord);
+  const char *Terminator = std::find(Chars, CharsEnd, '\0');
+  size_t Count = Terminator - Chars;
+  Str.append(Chars, Count);
+  assert(std::all_of(Terminator, std::min(CharsEnd,
+      Chars + (Count / sizeof(SPIRVWord) + 1) * sizeof(SPIRVWord)),
+      [](char Ch) { return Ch == '\0'; }) && "Invalid string in SPIRV");
+  I.IS.skip(Count / sizeof(SPIRVWord) + 1);
   return I;
 }
 
@@ -179,7 +177,6 @@ SPIRVDecoder::getWordCountAndOpCode() {
   WordCount = WordCountAndOpCode >> 16;
   OpCode = static_cast<Op>(WordCountAndOpCode & 0xFFFF);
 
-  assert(!IS.bad() && "SPIRV stream is bad");
   if (IS.fail()) {
     WordCount = 0;
     OpCode = OpNop;
@@ -204,7 +201,7 @@ SPIRVDecoder::getEntry() {
   else
       Entry->setScope(Scope);
 
-  assert(!IS.bad() && !IS.fail() && "SPIRV stream fails");
+  assert(!IS.fail() && "SPIRV stream fails");
   M.add(Entry);
   return Entry;
 }
@@ -213,7 +210,7 @@ void
 SPIRVDecoder::validate()const {
   assert(OpCode != OpNop && "Invalid op code");
   assert(WordCount && "Invalid word count");
-  assert(!IS.bad() && "Bad iInput stream");
+  assert(!IS.fail() && "Bad input stream");
 }
 
 }
@@ -81,20 +81,59 @@ namespace spv{
 class SPIRVFunction;
 class SPIRVBasicBlock;
 
+/// Read-only view of a SPIR-V binary held in memory as a sequence of words.
+/// The words are decoded in place, so the buffer must outlive the stream.
+/// Reads are bounds checked: reading past the end sets the fail flag and
+/// yields 0 instead of touching memory beyond the buffer.
+class SPIRVInputStream {
+public:
+  SPIRVInputStream(const SPIRVWord *Words, size_t NumWords)
+    :Begin(Words), Cur(Words), End(Words + NumWords), Failed(false){}
+
+  bool eof() const { return Cur >= End;}
+  bool fail() const { return Failed;}
+  size_t size() const { return End - Begin;}
+  size_t remaining() const { return End - Cur;}
+  const SPIRVWord *getPos() const { return Cur;}
+
+  SPIRVWord read() {
+    if (Cur >= End) {
+      Failed = true;
+      return 0;
+    }
+    return *Cur++;
+  }
+
+  void skip(size_t NumWords) {
+    if (NumWords > remaining()) {
+      Failed = true;
+      Cur = End;
+      return;
+    }
+    Cur += NumWords;
+  }
+
+private:
+  const SPIRVWord *Begin;
+  const SPIRVWord *Cur;
+  const SPIRVWord *End;
+  bool Failed;
+};
+
 class SPIRVDecoder {
 public:
-  SPIRVDecoder(std::istream& InputStream, SPIRVModule& Module)
+  SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVModule& Module)
     :IS(InputStream), M(Module), WordCount(0), OpCode(OpNop),
      Scope(NULL){}
-  SPIRVDecoder(std::istream& InputStream, SPIRVFunction& F);
-  SPIRVDecoder(std::istream& InputStream, SPIRVBasicBlock &BB);
+  SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVFunction& F);
+  SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVBasicBlock &BB);
 
   void setScope(SPIRVEntry *);
   bool getWordCountAndOpCode();
   SPIRVEntry *getEntry();
   void validate()const;
 
-  std::istream &IS;
+  SPIRVInputStream &IS;
   SPIRVModule &M;
   SPIRVWord WordCount;
   Op OpCode;
@@ -273,7 +273,7 @@ SPIRVType::isTypeVectorOrScalarFloat() const {
   return isTypeFloat() || isTypeVectorFloat();
 }
 
-void SPIRVTypeStruct::decode(std::istream &I)
+void SPIRVTypeStruct::decode(SPIRVInputStream &I)
 {
     auto Decoder = getDecoder(I);
     Decoder >> Id;
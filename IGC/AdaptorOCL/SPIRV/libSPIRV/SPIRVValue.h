@@ -203,7 +203,7 @@ protected:
     SPIRVValue::setWordCount(WordCount);
     NumWords = WordCount - 3;
   }
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Type >> Id;
     for (unsigned i = 0; i < NumWords; ++i)
       getDecoder(I) >> Union.Words[i];
@@ -0,0 +1,149 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2018 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+// Decodes a small hand-assembled module with lazy function bodies enabled
+// and checks that bodies are deferred until materialized, that annotations
+// on body values are applied either way, and that the result matches an
+// eager decode of the same words. Returns non-zero on failure.
+
+#include "libSPIRV/SPIRVModule.h"
+#include "libSPIRV/SPIRVFunction.h"
+#include "libSPIRV/SPIRVBasicBlock.h"
+#include "libSPIRV/SPIRVStream.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace spv;
+
+namespace
+{
+int NumFailures = 0;
+
+#define CHECK(Cond) \
+    do { if (!(Cond)) { std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Cond); ++NumFailures; } } while (0)
+
+SPIRVWord inst(SPIRVWord WordCount, Op OpCode)
+{
+    return (WordCount << 16) | OpCode;
+}
+
+// %3 is a function whose body is deferred. Its result %6 is named from the
+// module-level debug section. %7 decorates %10 from inside its own body, so
+// it has to be decoded while the module is read.
+std::vector<SPIRVWord> buildModule()
+{
+    const SPIRVWord K = 'k';
+    const SPIRVWord Sum = 's' | ('u' << 8) | ('m' << 16);
+    return {
+        MagicNumber, 0x00010000, 0, 11, 0,
+        inst(2, OpCapability), CapabilityAddresses,
+        inst(2, OpCapability), CapabilityKernel,
+        inst(3, OpMemoryModel), AddressingModelPhysical64, MemoryModelOpenCL,
+        inst(4, OpEntryPoint), ExecutionModelKernel, 3, K,
+        inst(3, OpName), 6, Sum,
+        inst(4, OpTypeInt), 1, 32, 0,
+        inst(4, OpTypeFunction), 2, 1, 1,
+
+        inst(5, OpFunction), 1, 3, FunctionControlMaskNone, 2,
+        inst(3, OpFunctionParameter), 1, 4,
+        inst(2, OpLabel), 5,
+        inst(5, OpIAdd), 1, 6, 4, 4,
+        inst(2, OpReturnValue), 6,
+        inst(1, OpFunctionEnd),
+
+        inst(5, OpFunction), 1, 7, FunctionControlMaskNone, 2,
+        inst(3, OpFunctionParameter), 1, 8,
+        inst(2, OpLabel), 9,
+        inst(3, OpDecorate), 10, DecorationRelaxedPrecision,
+        inst(5, OpIAdd), 1, 10, 8, 8,
+        inst(2, OpReturnValue), 10,
+        inst(1, OpFunctionEnd),
+    };
+}
+
+void checkBody(SPIRVModule &M, SPIRVFunction *F, SPIRVId Result)
+{
+    CHECK(F->isMaterialized());
+    CHECK(F->getNumBasicBlock() == 1);
+    if (F->getNumBasicBlock() == 1)
+    {
+        CHECK(F->getBasicBlock(0)->getNumInst() == 2);
+    }
+    CHECK(M.getEntry(Result)->getOpCode() == OpIAdd);
+}
+
+void testDecode(bool Lazy)
+{
+    std::vector<SPIRVWord> Words = buildModule();
+    std::unique_ptr<SPIRVModule> M(SPIRVModule::createSPIRVModule());
+    M->setLazyFunctionBodies(Lazy);
+    SPIRVInputStream IS(Words.data(), Words.size());
+    IS >> *M;
+
+    std::string ErrMsg;
+    CHECK(M->getError(ErrMsg) == SPIRVEC_Success);
+    CHECK(M->getNumFunctions() == 2);
+    if (M->getNumFunctions() != 2)
+    {
+        return;
+    }
+
+    SPIRVFunction *F = M->getFunction(0);
+    SPIRVFunction *G = M->getFunction(1);
+    CHECK(F->getId() == 3 && G->getId() == 7);
+    CHECK(F->hasBody() && G->hasBody());
+
+    if (Lazy)
+    {
+        CHECK(!F->isMaterialized());
+        CHECK(F->getNumBasicBlock() == 0);
+        CHECK(M->getEntry(6)->getOpCode() == OpForward);
+        F->materialize();
+    }
+
+    checkBody(*M, F, 6);
+    CHECK(M->getEntry(6)->getName() == "sum");
+
+    // Decoded eagerly in lazy mode because of the decoration in its body
+    checkBody(*M, G, 10);
+    CHECK(M->getEntry(10)->hasDecorate(DecorationRelaxedPrecision));
+}
+}
+
+int main()
+{
+    testDecode(false);
+    testDecode(true);
+    if (NumFailures)
+    {
+        std::printf("%d check(s) failed\n", NumFailures);
+        return 1;
+    }
+    return 0;
+}
@@ -160,7 +160,8 @@ namespace IGC
 static void CommonOCLBasedPasses(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    std::unique_ptr<llvm::MemoryBuffer> BuiltinCallGraph)
 {
     IGCPassManager mpm(pContext, "Unify");
 
@@ -267,7 +268,7 @@ static void CommonOCLBasedPasses(
 	}
 
     mpm.add(new PreBIImportAnalysis());
-    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule)));
+    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), std::move(BuiltinCallGraph)));
     mpm.add(new UndefinedReferencesPass());
 
     // Estimate maximal function size in the module and disable subroutine if not profitable.
@@ -439,15 +440,17 @@ static void CommonOCLBasedPasses(
 void UnifyIROCL(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    std::unique_ptr<llvm::MemoryBuffer> BuiltinCallGraph)
 {
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), std::move(BuiltinCallGraph));
 }
 
 void UnifyIRSPIR(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    std::unique_ptr<llvm::MemoryBuffer> BuiltinCallGraph)
 {
     int pointerSize = getPointerSize(*pContext->getModule());
 
@@ -465,6 +468,6 @@ void UnifyIRSPIR(
 		BuiltinSizeModule->setTargetTriple("vISA_64");
     }
 
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), std::move(BuiltinCallGraph));
 }
 }
@@ -26,15 +26,21 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 #include "Compiler/CodeGenPublic.h"
 
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Support/MemoryBuffer.h>
+#include "common/LLVMWarningsPop.hpp"
+
 namespace IGC
 {
     void UnifyIROCL(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        std::unique_ptr<llvm::MemoryBuffer> BuiltinCallGraph = nullptr);
 
     void UnifyIRSPIR(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        std::unique_ptr<llvm::MemoryBuffer> BuiltinCallGraph = nullptr);
 }
\ No newline at end of file
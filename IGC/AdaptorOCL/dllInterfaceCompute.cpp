@@ -326,13 +326,12 @@ bool ProcessElfInput(
               llvm::Module* pKernelModule = nullptr;
 #if defined(IGC_SPIRV_ENABLED)
               Context.setAsSPIRV();
-              std::istringstream IS(buf);
               std::string stringErrMsg;
               llvm::StringRef options;
               if(InputArgs.OptionsSize > 0){
                   options = llvm::StringRef(InputArgs.pOptions, InputArgs.OptionsSize - 1);
               }
-              bool success = spv::ReadSPIRV(toLLVMContext(Context), IS, pKernelModule, options, stringErrMsg);
+              bool success = spv::ReadSPIRV(toLLVMContext(Context), buf, pKernelModule, options, stringErrMsg);
 #else
               std::string stringErrMsg{ "SPIRV consumption not enabled for the TARGET." };
               bool success = false;
@@ -528,13 +527,12 @@ bool ParseInput(
     else if (inputDataFormatTemp == TB_DATA_FORMAT_SPIR_V) {
 #if defined(IGC_SPIRV_ENABLED)
         //convert SPIR-V binary to LLVM module
-        std::istringstream IS(strInput);        
         std::string stringErrMsg;
         llvm::StringRef options;
         if(pInputArgs->OptionsSize > 0){
             options = llvm::StringRef(pInputArgs->pOptions, pInputArgs->OptionsSize);
         }
-        bool success = spv::ReadSPIRV(oclContext, IS, pKernelModule, options, stringErrMsg);
+        bool success = spv::ReadSPIRV(oclContext, strInput, pKernelModule, options, stringErrMsg);
 #else
         std::string stringErrMsg{"SPIRV consumption not enabled for the TARGET."};
         bool success = false;
@@ -668,7 +666,9 @@ bool TranslateBuild(
     oclContext.setModule(pKernelModule);
     if (oclContext.isSPIRV())
     {
+        COMPILER_TIME_START(&oclContext, TIME_MetaData);
         deserialize(*oclContext.getModuleMetaData(), pKernelModule);
+        COMPILER_TIME_END(&oclContext, TIME_MetaData);
     }
 
 	oclContext.hash = inputShHash;
@@ -695,6 +695,7 @@ bool TranslateBuild(
         std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
         std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
         std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
+        std::unique_ptr<llvm::MemoryBuffer> pCallGraphBuffer = nullptr;
 		{
 			// IGC has two BIF Modules: 
 			//            1. kernel Module (pKernelModule)
@@ -763,6 +764,10 @@ bool TranslateBuild(
 
 				assert(BuiltinSizeModule
 					&& "Error loading builtin module from buffer");
+
+				// Call-graph index of the generic + size_t modules. Optional: BIImport walks
+				// the builtin modules when it is missing.
+				pCallGraphBuffer.reset(llvm::LoadBufferFromResource(ResNumber, "CG"));
 			}
 
 			BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
@@ -771,11 +776,11 @@ bool TranslateBuild(
 
         if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
         {
-            IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+            IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), std::move(pCallGraphBuffer));
         }
         else // not SPIR
         {
-            IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+            IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), std::move(pCallGraphBuffer));
         }
 
         if (!(oclContext.oclErrorMessage.empty()))
@@ -829,9 +834,9 @@ bool TranslateBuild(
     Util::BinaryStream programBinary;
     oclContext.m_programOutput.GetProgramBinary(programBinary, pointerSizeInBytes);
 
+    // The stream is sized exactly, take its buffer instead of copying it.
     int binarySize = static_cast<int>(programBinary.Size());
-    char* binaryOutput = new char[binarySize];
-    memcpy_s(binaryOutput, binarySize, (char*)programBinary.GetLinearPointer(), binarySize);
+    char* binaryOutput = programBinary.ReleaseBuffer();
 
 
     pOutputArgs->OutputSize = binarySize;
@@ -844,8 +849,7 @@ bool TranslateBuild(
     int debugDataSize = int_cast<int>(programDebugData.Size());
     if (debugDataSize > 0)
     {
-        char* debugDataOutput = new char[debugDataSize];
-        memcpy_s(debugDataOutput, debugDataSize, (char*)programDebugData.GetLinearPointer(), debugDataSize);
+        char* debugDataOutput = programDebugData.ReleaseBuffer();
 
         pOutputArgs->DebugDataSize = debugDataSize;
         pOutputArgs->pDebugData = debugDataOutput;
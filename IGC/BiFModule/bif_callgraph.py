@@ -0,0 +1,112 @@
+#===================== begin_copyright_notice ==================================
+
+#Copyright (c) 2017 Intel Corporation
+
+#Permission is hereby granted, free of charge, to any person obtaining a
+#copy of this software and associated documentation files (the
+#"Software"), to deal in the Software without restriction, including
+#without limitation the rights to use, copy, modify, merge, publish,
+#distribute, sublicense, and/or sell copies of the Software, and to
+#permit persons to whom the Software is furnished to do so, subject to
+#the following conditions:
+
+#The above copyright notice and this permission notice shall be included
+#in all copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+#MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+#IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+#CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+#TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+#SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#======================= end_copyright_notice ==================================
+
+# Builds the call-graph index of the builtin (BiF) modules which BIImport uses
+# to materialize only the transitive closure of the builtins a kernel calls.
+#
+# Input is the textual IR (llvm-dis output) of one or more BiF modules. Output
+# has one line per defined function, sorted by name:
+#
+#     <caller> [<callee> ...]
+#
+# Only direct calls are recorded (the same edges BIImport::GetCalledFunctions
+# follows); LLVM intrinsics are dropped since they are never imported.
+
+import os
+import re
+import sys
+
+
+
+def PrintHelp():
+    sys.stdout.write('Usage: {0} <output file> <input .ll file> [<input .ll file> ...]\n'.format(os.path.basename(__file__)))
+    sys.stdout.write('\n')
+    sys.stdout.write('    <output file>   - Path to output call-graph index.\n')
+    sys.stdout.write('    <input .ll file> - Disassembled BiF module to index.\n')
+
+
+
+nameRe   = r'(@(?:[-a-zA-Z$._][-a-zA-Z$._0-9]*|"[^"]*"))'
+defineRe = re.compile(r'^define\b[^@]*' + nameRe + r'\s*\(')
+callRe   = re.compile(r'\bcall\b[^@]*' + nameRe + r'\s*\(')
+
+
+
+def SymbolName(token):
+    name = token[1:]
+    if name.startswith('"'):
+        name = name[1:-1]
+    return name
+
+
+def IndexModule(inFile, callGraph):
+    caller = None
+    for line in inFile:
+        if caller is None:
+            match = defineRe.match(line)
+            if match:
+                caller = SymbolName(match.group(1))
+                callGraph.setdefault(caller, set())
+            continue
+
+        if line.startswith('}'):
+            caller = None
+            continue
+
+        for match in callRe.finditer(line):
+            callee = SymbolName(match.group(1))
+            if not callee.startswith('llvm.'):
+                callGraph[caller].add(callee)
+
+
+
+if len(sys.argv) < 3:
+    PrintHelp()
+    exit(0)
+for arg in sys.argv:
+    if arg == '-h' or arg == '--help':
+        PrintHelp()
+        exit(0)
+
+callGraph = dict()
+
+for inPath in sys.argv[2:]:
+    try:
+        with open(inPath, 'r') as inFile:
+            IndexModule(inFile, callGraph)
+    except EnvironmentError as ex:
+        sys.stderr.write('ERROR: Cannot read input file "{0}".\n       {1}.\n'.format(inPath, ex.strerror))
+        exit(1)
+
+try:
+    # Binary mode keeps '\n' line endings on every host; the index is
+    # embedded as-is and BIImport splits it on '\n'.
+    with open(sys.argv[1], 'wb') as outFile:
+        for caller in sorted(callGraph):
+            outFile.write((' '.join([caller] + sorted(callGraph[caller])) + '\n').encode('ascii'))
+except EnvironmentError as ex:
+    sys.stderr.write('ERROR: Cannot create/open output file "{0}".\n       {1}.\n'.format(sys.argv[1], ex.strerror))
+    exit(1)
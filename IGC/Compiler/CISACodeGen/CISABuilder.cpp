@@ -36,8 +36,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/secure_mem.h"
 #include "common/secure_string.h"
 #include "common/shaderOverride.hpp"
+#include "Compiler/CISACodeGen/SimdCostModel.hpp"
 
 #include <iStdLib/utility.h>
+#include <sstream>
 
 #if !defined(_WIN32)
 #   define _strdup strdup
@@ -3332,6 +3334,7 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
     CodeGenContext* context = m_program->GetContext();
     m_encoderState.m_secondHalf = false;
     m_enableVISAdump = false;
+    m_deferVISAdump = false;
     labelMap.clear();
     labelMap.resize(m_program->entry->size(), nullptr);
     labelCounter = 0;
@@ -3417,6 +3420,20 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
     SetVISAWaTable(m_program->m_Platform->getWATable());
 
     bool enableVISADump = IGC_IS_FLAG_ENABLED(EnableVISASlowpath) || IGC_IS_FLAG_ENABLED(ShaderDumpEnable);
+    // Building the vISA stream next to the G4 IR doubles the cost of every
+    // emitted instruction. In deferred mode only the G4 IR is built, unless
+    // a vISA file was explicitly asked for.
+    if (IGC_IS_FLAG_ENABLED(DeferVISADump) &&
+        IGC_IS_FLAG_ENABLED(ShaderDumpEnable) &&
+        IGC_IS_FLAG_DISABLED(EnableVISASlowpath) &&
+        IGC_IS_FLAG_DISABLED(EnableVISAOutput) &&
+        IGC_IS_FLAG_DISABLED(EnableVISABinary) &&
+        IGC_IS_FLAG_DISABLED(EnableVISADumpCommonISA) &&
+        !m_enableVISAdump)
+    {
+        enableVISADump = false;
+        m_deferVISAdump = true;
+    }
     V(CreateVISABuilder(vbuilder, vISA_3D, enableVISADump ? CM_CISA_BUILDER_BOTH : CM_CISA_BUILDER_GEN, 
         VISAPlatform, params.size(), params.data(), &m_WaTable));
 
@@ -3526,6 +3543,11 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         vbuilder->SetOption(vISA_LocalBankConflictReduction, false);
     }
 
+    if (IGC_IS_FLAG_ENABLED(enableGlobalLinearScanRA))
+    {
+        vbuilder->SetOption(vISA_GlobalLinearScanRA, true);
+    }
+
     if (IGC_IS_FLAG_ENABLED(disableVarSplit))
     {
         vbuilder->SetOption(vISA_LocalDeclareSplitInGlobalRA, false);
@@ -3747,6 +3769,13 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         vbuilder->SetOption(vISA_FuseTypedWrites, true);
     }
 
+    // Only has an effect when the kernel has stack-call functions, as those
+    // are the only separate compilation units in the builder.
+    if (IGC_IS_FLAG_ENABLED(EnableParallelVISACompile))
+    {
+        vbuilder->SetOption(vISA_ParallelCompileUnits, true);
+    }
+
     // Enable SendFusion for SIMD8 
     if (IGC_IS_FLAG_ENABLED(EnableSendFusion) &&
 		m_program->GetContext()->platform.supportSplitSend() &&
@@ -4064,6 +4093,15 @@ bool CEncoder::AvoidRetryOnSmallSpill() const
         context->m_retryManager.IsFirstTry();
 }
 
+/// Dump the G4 IR of the kernel when the vISA stream was not built
+/// (DeferVISADump). This is what is left for post-mortem debugging of a
+/// failed compile.
+void CEncoder::DumpDeferredVISA()
+{
+    std::string g4Name = IGC::Debug::GetDumpName(m_program, "g4");
+    V(vMainKernel->DumpG4IR(g4Name.c_str()));
+}
+
 void CEncoder::Compile()
 {
     COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISAEmitPass);
@@ -4129,6 +4167,35 @@ void CEncoder::Compile()
     }
 #endif
 
+    if (m_deferVISAdump &&
+        (vIsaCompile == -1 || vIsaCompile == -2 || IGC_IS_FLAG_ENABLED(FlushDeferredVISADump)))
+    {
+        DumpDeferredVISA();
+    }
+
+    if (IGC_IS_FLAG_ENABLED(DumpSIMDCostModelData) &&
+        context->type == ShaderType::OPENCL_SHADER &&
+        (vIsaCompile == 0 || vIsaCompile == -3))
+    {
+        // Outcome of this compile; joined with SIMDCostFeatures.csv on the
+        // hash and kernel name when fitting the SIMD cost model. A compile
+        // that aborted on spill counts as spilled and has no cycle estimate.
+        const bool aborted = vIsaCompile == -3;
+        uint staticCycle = 0;
+        for (uint i = 0; !aborted && i < jitInfo->BBNum; i++)
+        {
+            staticCycle += jitInfo->BBInfo[i].staticCycle;
+        }
+        std::ostringstream record;
+        record << std::hex << context->hash.getAsmHash() << std::dec << ","
+            << m_program->entry->getName().str() << ","
+            << numLanes(m_program->m_dispatchSize) << ","
+            << ((aborted || jitInfo->isSpill) ? 1 : 0) << ","
+            << (aborted ? 0 : jitInfo->numAsmCount) << ","
+            << staticCycle;
+        appendSimdCostModelRecord("SIMDCostOutcomes.csv", record.str());
+    }
+
     if( vIsaCompile == -1 )
     {
         assert(0 && "CM failure in vbuilder->Compile()");
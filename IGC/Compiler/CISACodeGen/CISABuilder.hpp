@@ -382,6 +382,7 @@ public:
     void BeginStackFunction(llvm::Function *F);
 
     void DestroyVISABuilder();
+    void DumpDeferredVISA();
 
 private:
     // helper functions
@@ -494,6 +495,9 @@ protected:
     VISABuilder* vbuilder;
     
     bool m_enableVISAdump;
+    /// vISA dumps were requested but the builder only builds G4 IR; the
+    /// kernel is dumped from its G4 IR on failure instead.
+    bool m_deferVISAdump;
     std::vector<VISA_LabelOpnd*> labelMap;
 
     /// Per kernel label counter
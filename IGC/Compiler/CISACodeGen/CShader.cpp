@@ -99,6 +99,8 @@ void CShader::InitEncoder(SIMDMode simdSize, bool canAbortOnSpill, ShaderDispatc
     rootMapping.clear();
     ccTupleMapping.clear();
     ConstantPool.clear();
+    bitCastMapping.clear();
+    m_VectorBCItoCVars.clear();
     setup.clear();
     patchConstantSetup.clear();
     encoder.SetProgram(this);
@@ -648,8 +650,12 @@ CVariable* CShader::BitCast( CVariable* var, VISA_Type newType )
     }
     else
     {
-        // TODO: we need to store this bitCasted var to avoid creating many times
-        bitCast = GetNewAlias( var, newType, 0, 0 );
+        CVariable*& cached = bitCastMapping[std::make_pair(var, (unsigned)newType)];
+        if (cached == nullptr)
+        {
+            cached = GetNewAlias(var, newType, 0, 0);
+        }
+        bitCast = cached;
     }
     return bitCast;
 }
@@ -1806,6 +1812,7 @@ void CShader::BeginFunction(llvm::Function *F)
     rootMapping.clear();
     ccTupleMapping.clear();
     ConstantPool.clear();
+    bitCastMapping.clear();
 
     bool useStackCall = m_FGA->useStackCall(F);
     if (useStackCall)
@@ -69,6 +69,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/CISACodeGen/CodeSinking.hpp"
 #include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
 #include "Compiler/IGCPassSupport.h"
 
@@ -273,74 +274,20 @@ bool CodeSinking::runOnFunction(Function &F)
     return everMadeChange;
 }
 
-static uint EstimateLiveOutPressure(BasicBlock *blk, const DataLayout *DL)
-{
-    // Walk the basic block bottom-up.  Remember if we saw a store.
-    uint pressure = 0;
-    BasicBlock::iterator I = blk->end();
-    --I;
-    bool processedBegin = false;
-    do {
-        Instruction *inst = &(*I);  // The instruction to sink.
-
-        // Predecrement I (if it's not begin) so that it isn't invalidated by sinking.
-        processedBegin = (I == blk->begin());
-        if (!processedBegin)
-            --I;
-
-        if (isa<DbgInfoIntrinsic>(inst))
-            continue;
-        // intrinsic like discard has no explicit use, get skipped here
-        if (inst->use_empty())
-            continue;
-
-        bool useOutside = false;
-        for (Value::user_iterator useI = inst->user_begin(), useE = inst->user_end(); 
-             !useOutside && useI != useE; ++useI) 
-        {
-            // Determine the block of the use.
-            Instruction *useInst = cast<Instruction>(*useI);
-            BasicBlock *useBlock = useInst->getParent();
-            if (useBlock != blk) 
-            {
-                if (PHINode *PN = dyn_cast<PHINode>(useInst))
-                {
-                    // PHI nodes use the operand in the predecessor block, 
-                    // not the block with the PHI.
-                    Use &U = useI.getUse();
-                    unsigned num = PHINode::getIncomingValueNumForOperand(U.getOperandNo());
-                    if (PN->getIncomingBlock(num) != blk)
-                    {
-                        useOutside = true;
-                    }
-                }
-                else
-                {
-                    useOutside = true;
-                }
-            }
-        }
-        
-        // estimate register usage by value
-        if (useOutside)
-        {
-            pressure += (uint)(DL->getTypeAllocSize(inst->getType()));
-        }
-        // If we just processed the first instruction in the block, we're done.
-    } while (!processedBegin);
-    return pressure;
-}
-
 bool CodeSinking::ProcessBlock(BasicBlock &blk) 
 {
     if (blk.empty())
         return false;
 
-    uint pressure0 = 0;
-    if (generalCodeSinking && registerPressureThreshold)
+    LiveOutPressureTracker liveOutPressure(DL);
+    const bool trackPressure = generalCodeSinking && registerPressureThreshold;
+    uint pressureLimit = 0;
+    if (trackPressure)
     {
-        // estimate live-out register pressure for this blk
-        pressure0 = EstimateLiveOutPressure(&blk, DL);
+        // estimate live-out register pressure for this blk; a sink that
+        // would raise it past the threshold is not done
+        liveOutPressure.init(&blk);
+        pressureLimit = liveOutPressure.getPressure() + registerPressureThreshold;
     }
 
     bool madeChange = false;
@@ -351,9 +298,6 @@ bool CodeSinking::ProcessBlock(BasicBlock &blk)
     --I;
     bool processedBegin = false;
     SmallPtrSet<Instruction *, 16> stores;
-    undoLocas.clear();
-    movedInsts.clear();
-    Instruction *prevLoca = 0x0;
     do {
         Instruction *inst = &(*I);  // The instruction to sink.
 
@@ -365,53 +309,33 @@ bool CodeSinking::ProcessBlock(BasicBlock &blk)
         if (inst->mayWriteToMemory())
         {
             stores.insert(inst);
-            prevLoca = inst;
         }
         // intrinsic like discard has no explict use, gets skipped here
         else if (isa<DbgInfoIntrinsic>(inst) || isa<TerminatorInst>(inst) || 
                  isa<PHINode>(inst) || inst->use_empty() )
         {
-            prevLoca = inst;
+            // nothing to sink
         }
         else {
-            Instruction *undoLoca = prevLoca;
-            prevLoca = inst;
             // diagnosis code: if (numChanges >= sinkLimit)
             // diagnosis code:    continue;
-            if (SinkInstruction(inst, stores))
+            if (SinkInstruction(inst, stores,
+                    trackPressure ? &liveOutPressure : nullptr, pressureLimit))
             {
+                if (trackPressure)
+                {
+                    liveOutPressure.instructionMovedOut(inst);
+                }
                 madeChange = true;
-                movedInsts.push_back(inst);
-                undoLocas.push_back(undoLoca);
                 // diagnosis code: numChanges++;
             }
         }
         // If we just processed the first instruction in the block, we're done.
     } while (!processedBegin);
 
-    if (generalCodeSinking && registerPressureThreshold)
+    if (madeChange)
     {
-        if (madeChange)
-        {
-            // measure the live-out register pressure again
-            uint pressure1 = EstimateLiveOutPressure(&blk, DL);
-            if (pressure1 > pressure0 + registerPressureThreshold)
-            {
-                // undo code motion
-                int numChanges = movedInsts.size();
-                for (int i = 0; i < numChanges; ++i)
-                {
-                    Instruction *undoLoca = undoLocas[i];
-                    assert(undoLoca);
-                    movedInsts[i]->moveBefore(undoLoca);
-                }
-                madeChange = false;
-            }
-            else
-            {
-                totalGradientMoved += numGradientMovedOutBB;
-            }
-        }
+        totalGradientMoved += numGradientMovedOutBB;
     }
 
     return madeChange;
@@ -572,9 +496,13 @@ bool CodeSinking::isSafeToMove(Instruction *inst
 }
 
 /// SinkInstruction - Determine whether it is safe to sink the specified machine
-/// instruction out of its current block into a successor.
+/// instruction out of its current block into a successor. With a pressure
+/// tracker, the move is also refused if the live-out pressure of the block
+/// would exceed pressureLimit.
 bool CodeSinking::SinkInstruction(Instruction *inst
-                                  , SmallPtrSetImpl<Instruction *> &Stores)
+                                  , SmallPtrSetImpl<Instruction *> &Stores
+                                  , const LiveOutPressureTracker *liveOutPressure
+                                  , unsigned pressureLimit)
 {
     // Check if it's safe to move the instruction.
     bool hasAliasConcern;
@@ -642,6 +570,12 @@ bool CodeSinking::SinkInstruction(Instruction *inst
         return false;
     }
 
+    if (liveOutPressure &&
+        liveOutPressure->getPressureIfMovedOut(inst) > pressureLimit)
+    {
+        return false;
+    }
+
     if (ComputesGradient(inst))
     {
         numGradientMovedOutBB++;
@@ -42,6 +42,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace IGC {
 
+class LiveOutPressureTracker;
+
 #define CODE_SINKING_MIN_SIZE  32
 
 class CodeSinking : public llvm::FunctionPass {
@@ -69,7 +71,8 @@ public:
 private:
     bool ProcessBlock(llvm::BasicBlock &blk);
     bool SinkInstruction(llvm::Instruction *I,
-        llvm::SmallPtrSetImpl<llvm::Instruction*> &Stores);
+        llvm::SmallPtrSetImpl<llvm::Instruction*> &Stores,
+        const LiveOutPressureTracker *liveOutPressure, unsigned pressureLimit);
     bool AllUsesDominatedByBlock(llvm::Instruction *inst,
         llvm::BasicBlock *blk,
         llvm::SmallPtrSetImpl<llvm::Instruction*> &usesInBlk) const;
@@ -85,9 +88,6 @@ private:
     /// data members for local-sinking
     llvm::SmallPtrSet<llvm::BasicBlock*, 8> localBlkSet;
     llvm::SmallPtrSet<llvm::Instruction*, 8> localInstSet;
-    /// data members for undo
-    std::vector<llvm::Instruction*> movedInsts;
-    std::vector<llvm::Instruction*> undoLocas;
     /// counting the number of gradient/sample operation sinked into CF
     unsigned totalGradientMoved;
     unsigned numGradientMovedOutBB;
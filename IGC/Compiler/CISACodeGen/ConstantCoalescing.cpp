@@ -33,6 +33,12 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/IGCPassSupport.h"
 #include "common/IGCIRBuilder.h"
 
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/Statistic.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/InstIterator.h>
+#include "common/LLVMWarningsPop.hpp"
+
 #include <list>
 
 /// @brief ConstantCoalescing merges multiple constant loads into one load
@@ -43,6 +49,12 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 using namespace llvm;
 using namespace IGC;
 
+#define DEBUG_TYPE "ConstantCoalescing"
+
+STATISTIC(NumCBLoadsBefore, "Number of constant-buffer loads before coalescing");
+STATISTIC(NumCBLoadsAfter, "Number of constant-buffer loads after coalescing");
+STATISTIC(NumCBLoadsHoisted, "Number of constant-buffer loads hoisted across blocks");
+
 // Register pass to igc-opt
 #define PASS_FLAG "igc-constant-coalescing"
 #define PASS_DESCRIPTION "Constant Coalescing merges multiple constant loads into one load of larger quantity"
@@ -110,6 +122,33 @@ void ConstantCoalescing::ProcessFunction( Function* function )
     // get the dominator-tree to traverse
     DominatorTree &dom_tree = getAnalysis<DominatorTreeWrapperPass>().getDomTree();
 
+    auto countCBLoads = [](Function* F)
+    {
+        uint count = 0;
+        for (auto &I : instructions(F))
+        {
+            uint bufId = 0;
+            Value *elt_ptrv = nullptr;
+            BufferType bufType = BUFFER_TYPE_UNKNOWN;
+            if (!I.use_empty() &&
+                IsReadOnlyLoadDirectCB(&I, bufId, elt_ptrv, bufType) &&
+                bufType == CONSTANT_BUFFER)
+            {
+                count++;
+            }
+        }
+        return count;
+    };
+    if (AreStatisticsEnabled())
+    {
+        NumCBLoadsBefore += countCBLoads(function);
+    }
+
+    if (IGC_IS_FLAG_ENABLED(EnableCBLoadHoisting))
+    {
+        HoistUniformLoads(function, dom_tree);
+    }
+
     // separate the loads into 3 streams to speed up process
     std::vector<BufChunk*> dircb_owloads;
     std::vector<BufChunk*> indcb_owloads;
@@ -173,6 +212,10 @@ void ConstantCoalescing::ProcessFunction( Function* function )
         indcb_gathers.pop_back();
         delete top_chunk;
     }
+    if (AreStatisticsEnabled())
+    {
+        NumCBLoadsAfter += countCBLoads(function);
+    }
     curFunc = nullptr;
     delete irBuilder;
     irBuilder = nullptr;
@@ -366,6 +409,172 @@ bool ConstantCoalescing::safeToMoveInstUp(Instruction* inst, Instruction* newLoc
 #define MAX_GATHER_SIZE  4  // 4 dwords
 #define MAX_VECTOR_INPUT 4  // 4 element
 
+/// check if the load is a uniform direct cb-load with an immediate offset,
+/// which can be executed anywhere in the function
+bool ConstantCoalescing::IsHoistableLoad(LoadInst *load, uint& eltid, uint& numelt)
+{
+    if (load->use_empty() || load->getType()->isAggregateType() ||
+        load->getType()->getScalarType()->getPrimitiveSizeInBits() != SIZE_DWORD * 8)
+    {
+        return false;
+    }
+    uint bufId = 0;
+    Value *elt_ptrv = nullptr;
+    BufferType bufType = BUFFER_TYPE_UNKNOWN;
+    // only constant buffers, which are never written, are safe to read early
+    if (!IsReadOnlyLoadDirectCB(load, bufId, elt_ptrv, bufType) ||
+        bufType != CONSTANT_BUFFER ||
+        elt_ptrv != load->getPointerOperand() ||
+        wiAns->whichDepend(load) != WIAnalysis::UNIFORM)
+    {
+        return false;
+    }
+    eltid = 0;
+    if (isa<IntToPtrInst>(elt_ptrv))
+    {
+        ConstantInt *elt_idx = dyn_cast<ConstantInt>(cast<Instruction>(elt_ptrv)->getOperand(0));
+        if (!elt_idx)
+        {
+            return false;
+        }
+        eltid = (uint)elt_idx->getZExtValue();
+        if ((int32_t)eltid < 0 || (eltid % 4) != 0)
+        {
+            return false;
+        }
+        eltid = (eltid >> 2); // bytes to dwords
+    }
+    else if (!isa<ConstantPointerNull>(elt_ptrv))
+    {
+        return false;
+    }
+    numelt = 1;
+    if (load->getType()->isVectorTy())
+    {
+        if (load->getType()->getVectorNumElements() > MAX_VECTOR_INPUT)
+        {
+            return false;
+        }
+        numelt = CheckVectorElementUses(load);
+        if (numelt == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// move the load to the end of the block, re-creating its address if the
+/// original one does not dominate that block
+void ConstantCoalescing::HoistLoad(LoadInst *load, BasicBlock *blk, DominatorTree& dom_tree)
+{
+    Instruction *insertPt = blk->getTerminator();
+    if (IntToPtrInst *ptr = dyn_cast<IntToPtrInst>(load->getPointerOperand()))
+    {
+        if (!dom_tree.dominates(ptr, insertPt))
+        {
+            Instruction *newPtr = ptr->clone();
+            newPtr->insertBefore(insertPt);
+            m_TT->RegisterNewValueAndAssignID(newPtr);
+            wiAns->incUpdateDepend(newPtr, WIAnalysis::UNIFORM);
+            load->setOperand(load->getPointerOperandIndex(), newPtr);
+        }
+    }
+    load->moveBefore(insertPt);
+    NumCBLoadsHoisted++;
+}
+
+/// The dominator-tree walk only coalesces a load into chunks from the blocks
+/// dominating it, so uniform loads of the same cb in divergent branches still
+/// end up in separate messages. Pair such loads up and hoist them into the
+/// nearest common dominator when they fit in one chunk. A load is never
+/// hoisted into a deeper loop than it started in, which would make it run on
+/// every iteration. Every hoisted dword stays live from that dominator to its
+/// uses; this is not checked against a register pressure estimate, only the
+/// number of dwords hoisted into a block is capped by CBLoadHoistingBudget.
+void ConstantCoalescing::HoistUniformLoads(Function* function, DominatorTree& dom_tree)
+{
+    LoopInfo loopInfo(dom_tree);
+
+    struct HoistCandidate
+    {
+        LoadInst* load;
+        uint eltid;
+        uint numelt;
+    };
+    // collect in dominator-tree pre-order, so that a candidate never
+    // dominates the ones before it
+    std::vector<HoistCandidate> candidates;
+    for (df_iterator<DomTreeNode*> dom_it = df_begin(dom_tree.getRootNode()),
+         dom_end = df_end(dom_tree.getRootNode()); dom_it != dom_end; ++dom_it)
+    {
+        for (auto &I : *dom_it->getBlock())
+        {
+            LoadInst *load = dyn_cast<LoadInst>(&I);
+            uint eltid = 0;
+            uint numelt = 0;
+            if (load && IsHoistableLoad(load, eltid, numelt))
+            {
+                candidates.push_back({ load, eltid, numelt });
+            }
+        }
+    }
+
+    const uint budget = IGC_GET_FLAG_VALUE(CBLoadHoistingBudget);
+    DenseMap<BasicBlock*, uint> hoistedSize;
+    std::vector<bool> hoisted(candidates.size(), false);
+    for (uint i = 0; i < candidates.size(); i++)
+    {
+        if (hoisted[i])
+        {
+            continue;
+        }
+        HoistCandidate &cand0 = candidates[i];
+        BasicBlock *blk0 = cand0.load->getParent();
+        for (uint j = i + 1; j < candidates.size(); j++)
+        {
+            HoistCandidate &cand1 = candidates[j];
+            BasicBlock *blk1 = cand1.load->getParent();
+            if (hoisted[j] ||
+                cand1.load->getPointerAddressSpace() != cand0.load->getPointerAddressSpace())
+            {
+                continue;
+            }
+            // loads in the same block or in dominated blocks are already
+            // coalesced by the dominator-tree walk
+            if (dom_tree.dominates(blk0, blk1))
+            {
+                continue;
+            }
+            uint lb = std::min(cand0.eltid, cand1.eltid);
+            uint ub = std::max(cand0.eltid + cand0.numelt, cand1.eltid + cand1.numelt);
+            if (ub - lb > MAX_OWLOAD_SIZE)
+            {
+                continue;
+            }
+            BasicBlock *dom_blk = dom_tree.findNearestCommonDominator(blk0, blk1);
+            // e.g. one load in a loop exit and the other after the loop
+            // have their common dominator in the loop
+            if (loopInfo.getLoopDepth(dom_blk) > loopInfo.getLoopDepth(blk0) ||
+                loopInfo.getLoopDepth(dom_blk) > loopInfo.getLoopDepth(blk1))
+            {
+                continue;
+            }
+            uint size = hoistedSize.lookup(dom_blk) + cand0.numelt + cand1.numelt;
+            if (size > budget)
+            {
+                continue;
+            }
+            hoistedSize[dom_blk] = size;
+            HoistLoad(cand0.load, dom_blk, dom_tree);
+            HoistLoad(cand1.load, dom_blk, dom_tree);
+            hoisted[i] = true;
+            hoisted[j] = true;
+            break;
+        }
+    }
+}
+
 void ConstantCoalescing::ProcessBlock(
     BasicBlock *blk, 
     std::vector<BufChunk*> &dircb_owloads,
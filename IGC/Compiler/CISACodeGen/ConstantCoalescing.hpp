@@ -84,6 +84,9 @@ public:
                      std::vector<BufChunk*> &indcb_owlds,
                      std::vector<BufChunk*> &indcb_gathers );
     void ProcessFunction(llvm::Function* function);
+    /// hoist uniform direct cb-loads in sibling blocks into their nearest
+    /// common dominator, so that the dominator-tree walk coalesces them
+    void HoistUniformLoads(llvm::Function* function, llvm::DominatorTree& dom_tree);
 
     virtual bool runOnFunction(llvm::Function &func) override;
 private:
@@ -228,6 +231,8 @@ private:
     /// used along ocl path, based upon int2ptr
     bool   DecomposePtrExp(llvm::Value *ptr_val, llvm::Value*& buf_idxv, llvm::Value*& elt_idxv, uint& eltid);
     uint   CheckVectorElementUses(llvm::Instruction *load);
+    bool   IsHoistableLoad(llvm::LoadInst *load, uint& eltid, uint& numelt);
+    void   HoistLoad(llvm::LoadInst *load, llvm::BasicBlock *blk, llvm::DominatorTree& dom_tree);
     void   AdjustChunk(BufChunk *cov_chunk, uint start_adj, uint size_adj);
     void   EnlargeChunk(BufChunk *cov_chunk, uint size_adj);
     void   MoveExtracts(BufChunk *cov_chunk, llvm::Instruction *load, uint start_adj);
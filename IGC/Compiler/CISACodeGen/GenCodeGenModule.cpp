@@ -32,15 +32,20 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "common/igc_regkeys.hpp"
+#include "common/debug/Debug.hpp"
+#include "AdaptorCommon/customApi.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SCCIterator.h"
 #include "llvm/Analysis/InlineCost.h"
+#include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/CallSite.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/ValueMap.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Transforms/IPO.h"
@@ -51,7 +56,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/DebugInfo/VISADebugEmitter.hpp"
 
+#include <algorithm>
 #include <numeric>
+#include <sstream>
 #include <utility>
 
 using namespace llvm;
@@ -694,19 +701,49 @@ void GenXFunctionGroupAnalysis::dump() {
 }
 #endif
 
+/// \brief A single block function containing only a few instructions.
+static bool isTrivialCall(const llvm::Function *F)
+{
+    if (!F->empty() && F->size() == 1)
+        return F->front().size() <= 5;
+    return false;
+}
+
 namespace {
 
 /// \brief Custom inliner for subroutines.
+///
+/// With SubroutineInlinerBudget set, call sites are not inlined by the size
+/// threshold alone. They are ranked by estimated call frequency times callee
+/// size and inlined greedily while every kernel reaching them stays within
+/// the budget; see planBudgetedInlining. The remaining calls are left as
+/// subroutine or stack calls.
 class SubroutineInliner : public LegacyInlinerBase {
     EstimateFunctionSize *FSA;
 
+    /// Call sites are tracked by value handle: a call deleted by inlining
+    /// or with its function drops out of the plan, so a call later
+    /// allocated at the same address is not mistaken for a planned one.
+    /// Replacing a call's uses does not move its entry.
+    struct BudgetedCallsConfig
+        : llvm::ValueMapConfig<const llvm::Instruction *> {
+        enum { FollowRAUW = false };
+    };
+
+    /// Call sites selected for inlining by planBudgetedInlining.
+    llvm::ValueMap<const llvm::Instruction *, bool, BudgetedCallsConfig>
+        BudgetedCalls;
+    bool BudgetPlanned;
+
+    void planBudgetedInlining(llvm::Module &M);
+
 public:
     static char ID; // Pass identification, replacement for typeid
 
     // Use extremely low threshold.
     SubroutineInliner()
       : LegacyInlinerBase(ID, /*InsertLifetime*/ false),
-        FSA(nullptr) {}
+        FSA(nullptr), BudgetPlanned(false) {}
 
     InlineCost getInlineCost(CallSite CS) override;
 
@@ -737,9 +774,158 @@ void SubroutineInliner::getAnalysisUsage(AnalysisUsage &AU) const
 bool SubroutineInliner::runOnSCC(CallGraphSCC &SCC) 
 {
     FSA = &getAnalysis<EstimateFunctionSize>(); 
+    if (IGC_GET_FLAG_VALUE(SubroutineInlinerBudget) != 0 && !BudgetPlanned)
+    {
+        // Plan once on the original call graph; call sites cloned by later
+        // inlining are not in the plan and stay calls.
+        planBudgetedInlining(SCC.getCallGraph().getModule());
+        BudgetPlanned = true;
+    }
     return LegacyInlinerBase::runOnSCC(SCC);
 }
 
+/// \brief Select the call sites to inline under SubroutineInlinerBudget.
+///
+/// Each call site gets a frequency of 8^loop-depth, a benefit of frequency
+/// times the callee size, and a cost: the expanded size of the callee from
+/// EstimateFunctionSize, or 0 when the callee is trivial or only called once
+/// (its standalone copy goes away). Kernels start at the size of all the
+/// functions they reach, i.e. with no inlining. Call sites are visited from
+/// the highest benefit, cheapest first on ties, and one is taken when no
+/// kernel reaching its caller goes over the budget.
+void SubroutineInliner::planBudgetedInlining(llvm::Module &M)
+{
+    struct Candidate
+    {
+        const CallInst *CI;
+        Function *Caller;
+        Function *Callee;
+        uint64_t Freq;
+        uint64_t Benefit;
+        std::size_t Cost;
+    };
+
+    const std::size_t Budget = IGC_GET_FLAG_VALUE(SubroutineInlinerBudget);
+
+    auto getSize = [](const Function &F) {
+        std::size_t Size = 0;
+        for (auto &BB : F)
+            Size += BB.size();
+        return Size;
+    };
+
+    std::vector<Candidate> Candidates;
+    llvm::DenseMap<Function *, std::vector<Function *>> Callees;
+    std::vector<Function *> Kernels;
+    for (auto &F : M)
+    {
+        if (F.empty())
+            continue;
+
+        bool IsCalled = false;
+        for (auto U : F.users())
+            IsCalled |= isa<CallInst>(U);
+        if (!IsCalled)
+            Kernels.push_back(&F);
+
+        DominatorTree DT(F);
+        LoopInfo LI(DT);
+        for (auto &BB : F)
+        {
+            uint64_t Freq = getLoopFrequencyWeight(LI, &BB);
+            for (auto &I : BB)
+            {
+                auto CI = dyn_cast<CallInst>(&I);
+                Function *Callee = CI ? CI->getCalledFunction() : nullptr;
+                if (!Callee || Callee->isDeclaration())
+                    continue;
+                Callees[&F].push_back(Callee);
+                if (Callee == &F || !isInlineViable(*Callee) ||
+                    Callee->hasFnAttribute("InstrumentedFunc"))
+                    continue;
+
+                std::size_t Cost = 0;
+                if (!isTrivialCall(Callee) && !FSA->onlyCalledOnce(Callee))
+                    Cost = FSA->getExpandedSize(Callee);
+                Candidates.push_back(
+                    { CI, &F, Callee, Freq, Freq * getSize(*Callee), Cost });
+            }
+        }
+    }
+
+    // Kernels reaching each function and the size of each kernel with no
+    // inlining (every reachable function compiled once).
+    llvm::DenseMap<Function *, std::vector<Function *>> ReachingKernels;
+    llvm::DenseMap<Function *, std::size_t> KernelSize;
+    for (auto K : Kernels)
+    {
+        llvm::SmallPtrSet<Function *, 16> Visited;
+        std::vector<Function *> Worklist(1, K);
+        std::size_t Size = 0;
+        while (!Worklist.empty())
+        {
+            Function *F = Worklist.back();
+            Worklist.pop_back();
+            if (!Visited.insert(F).second)
+                continue;
+            Size += getSize(*F);
+            ReachingKernels[F].push_back(K);
+            for (auto G : Callees[F])
+                Worklist.push_back(G);
+        }
+        KernelSize[K] = Size;
+    }
+    llvm::DenseMap<Function *, std::size_t> InitialKernelSize = KernelSize;
+
+    std::stable_sort(Candidates.begin(), Candidates.end(),
+        [](const Candidate &A, const Candidate &B) {
+            if (A.Benefit != B.Benefit)
+                return A.Benefit > B.Benefit;
+            return A.Cost < B.Cost;
+        });
+
+    std::stringstream Report;
+    bool DumpDecisions = IGC_IS_FLAG_ENABLED(DumpSubroutineInlinerDecisions);
+    for (auto &C : Candidates)
+    {
+        // Free sites are always taken, as the threshold mode does, even
+        // when a kernel already starts over the budget.
+        auto &Reaching = ReachingKernels[C.Caller];
+        bool Fits = C.Cost == 0 ||
+            std::all_of(Reaching.begin(), Reaching.end(),
+                [&](Function *K) {
+                    return C.Cost <= Budget && KernelSize[K] <= Budget - C.Cost;
+                });
+        if (Fits)
+        {
+            for (auto K : Reaching)
+                KernelSize[K] += C.Cost;
+            BudgetedCalls[C.CI] = true;
+        }
+        if (DumpDecisions)
+        {
+            Report << (Fits ? "inline " : "call   ")
+                   << C.Caller->getName().str() << " -> "
+                   << C.Callee->getName().str()
+                   << " freq " << C.Freq << " benefit " << C.Benefit
+                   << " cost " << C.Cost << "\n";
+        }
+    }
+
+    if (DumpDecisions)
+    {
+        for (auto K : Kernels)
+        {
+            Report << "kernel " << K->getName().str()
+                   << ": estimated size " << InitialKernelSize[K]
+                   << " -> " << KernelSize[K]
+                   << " (budget " << Budget << ")\n";
+        }
+
+        IGC::Debug::AppendToDumpFile("SubroutineInliner.txt", Report.str());
+    }
+}
+
 /// \brief Get the inline cost for the subroutine-inliner.
 ///
 InlineCost SubroutineInliner::getInlineCost(CallSite CS) 
@@ -764,14 +950,11 @@ InlineCost SubroutineInliner::getInlineCost(CallSite CS)
         if (FCtrl != FLAG_FCALL_FORCE_SUBROUTINE &&
             FCtrl != FLAG_FCALL_FORCE_STACKCALL)
         {
-            std::size_t Threshold = IGC_GET_FLAG_VALUE(SubroutineInlinerThreshold);
+            if (IGC_GET_FLAG_VALUE(SubroutineInlinerBudget) != 0)
+                return BudgetedCalls.count(CS.getInstruction()) ?
+                    InlineCost::getAlways() : InlineCost::getNever();
 
-            // A single block function containing only a few instructions.
-            auto isTrivialCall = [](const llvm::Function *F) {
-                if (!F->empty() && F->size() == 1)
-                    return F->front().size() <= 5;
-                return false;
-            };
+            std::size_t Threshold = IGC_GET_FLAG_VALUE(SubroutineInlinerThreshold);
 
             if (FSA->getExpandedSize(Caller) <= Threshold ||
                 FSA->onlyCalledOnce(Callee) || isTrivialCall(Callee))
@@ -30,6 +30,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "common/debug/Debug.hpp"
+#include "AdaptorCommon/customApi.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Function.h>
@@ -37,6 +39,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/ADT/SmallVector.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include <algorithm>
+#include <sstream>
+
 #define MAX_ALLOCA_PROMOTE_GRF_NUM      48
 #define MAX_PRESSURE_GRF_NUM            64
 
@@ -51,6 +56,7 @@ using namespace IGC::IGCMD;
 #define PASS_ANALYSIS false
 IGC_INITIALIZE_PASS_BEGIN(LowerGEPForPrivMem, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 IGC_INITIALIZE_PASS_DEPENDENCY(RegisterPressureEstimate)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
 IGC_INITIALIZE_PASS_END(LowerGEPForPrivMem, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
@@ -91,9 +97,15 @@ bool LowerGEPForPrivMem::runOnFunction(llvm::Function &F)
     m_pRegisterPressureEstimate = &getAnalysis<RegisterPressureEstimate>();
 
     m_allocasToPrivMem.clear();
+    m_promotionCandidates.clear();
 
     visit(F);
 
+    if (IGC_GET_FLAG_VALUE(PrivMemPromotionGRFBudget) != 0)
+    {
+        SelectAllocasUnderBudget();
+    }
+
     m_toBeRemovedGEP.clear();
     m_toBeRemovedLoadStore.clear();
 
@@ -178,6 +190,11 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
         // as they will be allocated as uniform array
         allocaSize = iSTD::Round(allocaSize, 8) / 8;
     }
+    return CheckAndUpdatePressure(pAlloca, allocaSize);
+}
+
+bool LowerGEPForPrivMem::CheckAndUpdatePressure(llvm::AllocaInst* pAlloca, unsigned int allocaSize)
+{
     // get all the basic blocks that contain the uses of the alloca
     // then estimate how much changing this alloca to register adds to the pressure at that block.
     unsigned int assignedNumber = 0;
@@ -227,6 +244,130 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
     return true;
 }
 
+unsigned int LowerGEPForPrivMem::GetPromotionSIMDWidth()
+{
+    switch (m_ctx->type)
+    {
+    case ShaderType::VERTEX_SHADER:
+    case ShaderType::HULL_SHADER:
+    case ShaderType::DOMAIN_SHADER:
+    case ShaderType::GEOMETRY_SHADER:
+        return numLanes(SIMDMode::SIMD8);
+    case ShaderType::COMPUTE_SHADER:
+    {
+        ComputeShaderContext* ctx = static_cast<ComputeShaderContext*>(m_ctx);
+        return std::max(numLanes(ctx->GetLeastSIMDModeAllowed()), numLanes(SIMDMode::SIMD16));
+    }
+    case ShaderType::OPENCL_SHADER:
+    {
+        MetaDataUtils *pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+        int subGrpSize = pMdUtils->getFunctionsInfoItem(m_pFunc)->getSubGroupSize()->getSIMD_size();
+        if (subGrpSize > 0)
+        {
+            return subGrpSize;
+        }
+        return numLanes(SIMDMode::SIMD16);
+    }
+    default:
+        return numLanes(SIMDMode::SIMD16);
+    }
+}
+
+// Loads and stores reached from the alloca through GEPs and bitcasts,
+// weighted by 8^loop-depth.
+static uint64_t CountAllocaAccesses(Instruction* I, LoopInfo& LI)
+{
+    uint64_t count = 0;
+    for (auto U : I->users())
+    {
+        Instruction* pUser = cast<Instruction>(U);
+        if (isa<GetElementPtrInst>(pUser) || isa<BitCastInst>(pUser))
+        {
+            count += CountAllocaAccesses(pUser, LI);
+        }
+        else if (isa<LoadInst>(pUser) || isa<StoreInst>(pUser))
+        {
+            count += getLoopFrequencyWeight(LI, pUser->getParent());
+        }
+    }
+    return count;
+}
+
+void LowerGEPForPrivMem::SelectAllocasUnderBudget()
+{
+    struct Candidate
+    {
+        AllocaInst* pAlloca;
+        uint64_t accesses;
+        unsigned int size;
+        unsigned int lanes;
+        unsigned int numGRF;
+    };
+
+    LoopInfo& LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+    const unsigned int simdWidth = GetPromotionSIMDWidth();
+
+    std::vector<Candidate> candidates;
+    for (auto pAlloca : m_promotionCandidates)
+    {
+        bool isUniformAlloca = true;
+        if (!ValidUses(pAlloca, isUniformAlloca))
+        {
+            continue;
+        }
+        unsigned int size = extractAllocaSize(pAlloca);
+        // A uniform alloca is allocated once, otherwise once per lane.
+        unsigned int lanes = isUniformAlloca ? 1 : simdWidth;
+        unsigned int numGRF = iSTD::Round(size * lanes, SIZE_GRF) / SIZE_GRF;
+        candidates.push_back({ pAlloca, CountAllocaAccesses(pAlloca, LI), size, lanes, numGRF });
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) {
+            if (a.accesses != b.accesses)
+                return a.accesses > b.accesses;
+            return a.numGRF < b.numGRF;
+        });
+
+    unsigned int budget = IGC_GET_FLAG_VALUE(PrivMemPromotionGRFBudget);
+    unsigned int bytesToGRF = 0;
+    bool dumpDecisions = IGC_IS_FLAG_ENABLED(DumpPrivMemPromotion) && !candidates.empty();
+    std::stringstream report;
+    if (dumpDecisions)
+    {
+        report << m_pFunc->getName().str() << " SIMD" << simdWidth
+               << " budget " << budget << " GRFs\n";
+    }
+    for (auto& C : candidates)
+    {
+        bool promote = C.numGRF <= budget;
+        if (promote && m_pRegisterPressureEstimate->isAvailable())
+        {
+            // Same per-lane pressure units as CheckIfAllocaPromotable.
+            unsigned int pressureSize = C.lanes == 1 ? iSTD::Round(C.size, 8) / 8 : C.size;
+            promote = CheckAndUpdatePressure(C.pAlloca, pressureSize);
+        }
+        if (promote)
+        {
+            budget -= C.numGRF;
+            bytesToGRF += C.size * C.lanes;
+            m_allocasToPrivMem.push_back(C.pAlloca);
+        }
+        if (dumpDecisions)
+        {
+            report << (promote ? "grf     " : "scratch ") << C.pAlloca->getName().str()
+                   << " size " << C.size << " lanes " << C.lanes
+                   << " grfs " << C.numGRF << " accesses " << C.accesses << "\n";
+        }
+    }
+
+    if (dumpDecisions)
+    {
+        report << "bytes moved from scratch to GRF: " << bytesToGRF << "\n";
+        IGC::Debug::AppendToDumpFile("PrivMemPromotion.txt", report.str());
+    }
+}
+
 bool LowerGEPForPrivMem::IsUniformAddress(Value* val)
 {
     if(isa<Constant>(val))
@@ -388,6 +529,13 @@ void LowerGEPForPrivMem::visitAllocaInst(AllocaInst &I)
     // Alloca should always be private memory
     assert(I.getType()->getAddressSpace() == ADDRESS_SPACE_PRIVATE);
 
+    if (IGC_GET_FLAG_VALUE(PrivMemPromotionGRFBudget) != 0)
+    {
+        // Ranked against the other allocas of the function in SelectAllocasUnderBudget.
+        m_promotionCandidates.push_back(&I);
+        return;
+    }
+
     if (!CheckIfAllocaPromotable(&I))
     {
         // alloca size extends remain per-lane-reg space
@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
+#include <llvm/Analysis/LoopInfo.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/ADT/SmallVector.h>
 #include "common/LLVMWarningsPop.hpp"
@@ -58,6 +59,7 @@ namespace IGC
         virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
         {
             AU.addRequired<RegisterPressureEstimate>();
+            AU.addRequired<llvm::LoopInfoWrapperPass>();
             AU.addRequired<MetaDataUtilsWrapper>();
             AU.addRequired<CodeGenContextWrapper>();
             AU.setPreservesCFG();
@@ -103,6 +105,17 @@ namespace IGC
 
         bool CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca);
 
+        /// Check that promoting an alloca of allocaSize keeps the pressure of
+        /// the blocks in its live range acceptable, and account for it if so.
+        bool CheckAndUpdatePressure(llvm::AllocaInst* pAlloca, unsigned int allocaSize);
+
+        /// With PrivMemPromotionGRFBudget: choose which of m_promotionCandidates
+        /// are promoted, most accessed first, within the GRF budget.
+        void SelectAllocasUnderBudget();
+
+        /// Lanes an alloca is replicated over once promoted to GRF.
+        unsigned int GetPromotionSIMDWidth();
+
         /// Conservatively check if a store allow an Alloca to be uniform
         bool IsUniformStore(llvm::StoreInst* pStore);
         /// Check if the pointer arithmetic after the alloca is uniform
@@ -117,6 +130,7 @@ namespace IGC
         std::vector<llvm::Instruction*>                      m_toBeRemovedGEP;
         std::vector<llvm::Instruction*>                      m_toBeRemovedLoadStore;
         std::vector<llvm::AllocaInst*>                       m_allocasToPrivMem;
+        std::vector<llvm::AllocaInst*>                       m_promotionCandidates;
         RegisterPressureEstimate*                            m_pRegisterPressureEstimate;
         llvm::Function                                      *m_pFunc;
 
@@ -24,13 +24,19 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 ======================= end_copyright_notice ==================================*/
 #include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/PostOrderIterator.h>
 #include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/Statistic.h>
 #include <llvm/Analysis/AliasAnalysis.h>
 #include <llvm/Analysis/InstructionSimplify.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/PostDominators.h>
 #include <llvm/Analysis/ScalarEvolution.h>
 #include <llvm/Analysis/ScalarEvolutionExpressions.h>
 #include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Dominators.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/GlobalAlias.h>
 #include <llvm/IR/IRBuilder.h>
@@ -50,6 +56,12 @@ using namespace llvm;
 using namespace IGC;
 using namespace IGC::IGCMD;
 
+#define DEBUG_TYPE "MemOpt"
+
+STATISTIC(NumLoadMsgEliminated, "Number of load messages eliminated by merging");
+STATISTIC(NumStoreMsgEliminated, "Number of store messages eliminated by merging");
+STATISTIC(NumCrossBlockMerges, "Number of merges spanning more than one BB");
+
 namespace {
   // This pass merge consecutive loads/stores within a BB when it's safe:
   // - Two loads (one of them is denoted as the leading load if it happens
@@ -62,6 +74,10 @@ namespace {
   //   the non-tailing store is merged into the tailing one, iff there's no
   //   memory dependency between them which may results in different result.
   //
+  // With EnableMemOptCrossBB, loads/stores from control-equivalent BBs, i.e.
+  // BBs executed exactly as many times as each other, are merged as well. All
+  // memory references on any path between them are checked as above.
+  //
   class MemOpt : public FunctionPass {
     const DataLayout *DL;
     AliasAnalysis *AA;
@@ -71,6 +87,15 @@ namespace {
     CodeGenContext *CGC;
     TargetLibraryInfo *TLI;
 
+    // Only available when merging across BBs.
+    DominatorTree *DT;
+    PostDominatorTree *PDT;
+    LoopInfo *LI;
+
+    // Map from BB to the ID of its control-equivalent class. BBs not in any
+    // class with more than one BB are not recorded.
+    DenseMap<const BasicBlock *, unsigned> EquivClass;
+
     // Map of profit vector lengths per scalar type. Each entry specifies the
     // profit vector length of a given scalar type.
     // NOTE: Prepare the profit vector lengths in the *DESCENDING* order.
@@ -81,13 +106,16 @@ namespace {
     // previous memory reference in this list.
     typedef std::vector<std::pair<Instruction *, unsigned> > MemRefListTy;
     typedef std::vector<Instruction *> TrivialMemRefListTy;
+    // Lists of BBs whose memory references are scanned together, each in the
+    // program order.
+    typedef SmallVector<SmallVector<BasicBlock *, 4>, 16> BlockListsTy;
 
   public:
     static char ID;
 
     MemOpt() :
         FunctionPass(ID), DL(nullptr), AA(nullptr), SE(nullptr), WI(nullptr),
-        CGC(nullptr) {
+        CGC(nullptr), TLI(nullptr), DT(nullptr), PDT(nullptr), LI(nullptr) {
       initializeMemOptPass(*PassRegistry::getPassRegistry());
     }
 
@@ -102,10 +130,33 @@ namespace {
       AU.addRequired<TargetLibraryInfoWrapperPass>();
       AU.addRequired<ScalarEvolutionWrapperPass>();
       AU.addRequired<WIAnalysis>();
+      if (IGC_IS_FLAG_ENABLED(EnableMemOptCrossBB)) {
+        AU.addRequired<DominatorTreeWrapperPass>();
+        AU.addRequired<PostDominatorTreeWrapperPass>();
+        AU.addRequired<LoopInfoWrapperPass>();
+      }
     }
 
     void buildProfitVectorLengths(Function &F);
 
+    void collectBlockLists(Function &F, BlockListsTy &BlockLists);
+    bool getControlEquivalentRegion(BasicBlock *Head, BasicBlock *Tail,
+                                    const DenseSet<BasicBlock *> &Assigned,
+                                    SmallVectorImpl<BasicBlock *> &Region) const;
+
+    /// Check whether a memory reference could be merged with the leading
+    /// one, i.e. they are in the same BB or in control-equivalent BBs.
+    bool isControlEquivalent(const Instruction *Leading,
+                             const Instruction *Next) const {
+      if (Leading->getParent() == Next->getParent())
+        return true;
+      auto LeadingIt = EquivClass.find(Leading->getParent());
+      if (LeadingIt == EquivClass.end())
+        return false;
+      auto NextIt = EquivClass.find(Next->getParent());
+      return NextIt != EquivClass.end() && NextIt->second == LeadingIt->second;
+    }
+
     bool mergeLoad(LoadInst *LeadingLoad, MemRefListTy::iterator MI,
                    MemRefListTy &MemRefs, TrivialMemRefListTy &ToOpt);
     bool mergeStore(StoreInst *LeadingStore, MemRefListTy::iterator MI,
@@ -321,12 +372,17 @@ IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(AAResultsWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(TargetLibraryInfoWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_END(MemOpt, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char MemOpt::ID = 0;
 
 // Limit for the number of instructions to scan from the leading load/store.
 static const unsigned MaxScanLimit = 150;
+// Limit for the number of BBs in a region scanned across BBs.
+static const unsigned MaxRegionBlocks = 32;
 
 void MemOpt::buildProfitVectorLengths(Function &F) {
   ProfitVectorLengths.clear();
@@ -368,27 +424,38 @@ bool MemOpt::runOnFunction(Function &F) {
   CGC = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
   TLI = &getAnalysis<TargetLibraryInfoWrapperPass>().getTLI();
 
+  if (IGC_IS_FLAG_ENABLED(EnableMemOptCrossBB)) {
+    DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+    PDT = &getAnalysis<PostDominatorTreeWrapperPass>().getPostDomTree();
+    LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+  }
+
   if (ProfitVectorLengths.empty())
     buildProfitVectorLengths(F);
 
   bool Changed = false;
 
-  for (Function::iterator BB = F.begin(), BBE = F.end(); BB != BBE; ++BB) {
+  BlockListsTy BlockLists;
+  collectBlockLists(F, BlockLists);
+
+  for (auto &Blocks : BlockLists) {
     // Find all instructions with memory reference. Remember the distance one
     // by one.
     MemRefListTy MemRefs;
     TrivialMemRefListTy MemRefsToOptimize;
     unsigned Distance = 0;
     bool FirstMemRef = true;
-    for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI) {
-      Instruction *I = &(*BI);
-      Distance += FirstMemRef ? 0 : 1;
-      // Skip irrelevant instructions.
-      if (shouldSkip(I))
-        continue;
-      MemRefs.push_back(std::make_pair(I, Distance));
-      Distance = 0;
-      FirstMemRef = false;
+    for (auto *BB : Blocks) {
+      for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI) {
+        Instruction *I = &(*BI);
+        Distance += FirstMemRef ? 0 : 1;
+        // Skip irrelevant instructions.
+        if (shouldSkip(I))
+          continue;
+        MemRefs.push_back(std::make_pair(I, Distance));
+        Distance = 0;
+        FirstMemRef = false;
+      }
     }
 
     // Skip BB with no more than 2 loads/stores.
@@ -422,10 +489,122 @@ bool MemOpt::runOnFunction(Function &F) {
   DL = nullptr;
   AA = nullptr;
   SE = nullptr;
+  DT = nullptr;
+  PDT = nullptr;
+  LI = nullptr;
+  EquivClass.clear();
 
   return Changed;
 }
 
+/// collectBlockLists() - groups BBs into lists whose memory references are
+/// scanned together. By default, each BB forms its own list. When merging
+/// across BBs, a chain of control-equivalent BBs, i.e. BBs dominated by the
+/// head of that chain and post-dominating it within the same loop, forms a
+/// list together with all BBs in between. That list is arranged in the
+/// reverse post-order so that any memory reference on a path between two
+/// references in that chain is scanned between them as well.
+void MemOpt::collectBlockLists(Function &F, BlockListsTy &BlockLists) {
+  EquivClass.clear();
+
+  if (!DT) {
+    for (auto &BB : F)
+      BlockLists.push_back({ &BB });
+    return;
+  }
+
+  ReversePostOrderTraversal<Function *> RPOT(&F);
+  DenseMap<BasicBlock *, unsigned> RPONum;
+  unsigned Num = 0;
+  for (auto *BB : RPOT)
+    RPONum[BB] = Num++;
+
+  DenseSet<BasicBlock *> Assigned;
+  unsigned NumClasses = 0;
+  for (auto *Head : RPOT) {
+    if (Assigned.count(Head))
+      continue;
+
+    // All BBs control-equivalent to the head are on its post-dominator tree
+    // path and dominated by the head. Once a BB on that path is not dominated
+    // by the head, none of the remaining ones is.
+    SmallVector<BasicBlock *, 8> Chain;
+    Chain.push_back(Head);
+    Loop *L = LI->getLoopFor(Head);
+    if (DomTreeNode *Node = PDT->getNode(Head)) {
+      for (Node = Node->getIDom(); Node && Node->getBlock();
+           Node = Node->getIDom()) {
+        BasicBlock *BB = Node->getBlock();
+        if (!DT->dominates(Head, BB) || Assigned.count(BB))
+          break;
+        if (LI->getLoopFor(BB) == L)
+          Chain.push_back(BB);
+      }
+    }
+
+    // Shrink the chain until the region it spans is well-formed.
+    SmallVector<BasicBlock *, 16> Region;
+    while (Chain.size() > 1 &&
+           !getControlEquivalentRegion(Head, Chain.back(), Assigned, Region))
+      Chain.pop_back();
+
+    if (Chain.size() == 1) {
+      Assigned.insert(Head);
+      BlockLists.push_back({ Head });
+      continue;
+    }
+
+    std::sort(Region.begin(), Region.end(),
+              [&](BasicBlock *A, BasicBlock *B) {
+                return RPONum[A] < RPONum[B];
+              });
+    ++NumClasses;
+    for (auto *BB : Chain)
+      EquivClass[BB] = NumClasses;
+    for (auto *BB : Region)
+      Assigned.insert(BB);
+    BlockLists.push_back(SmallVector<BasicBlock *, 4>(Region.begin(),
+                                                      Region.end()));
+  }
+
+  // Unreachable BBs are not visited in the reverse post-order.
+  for (auto &BB : F)
+    if (!Assigned.count(&BB))
+      BlockLists.push_back({ &BB });
+}
+
+/// getControlEquivalentRegion() - collects BBs on paths from the head to the
+/// tail. Returns false if any path leaves that region other than through the
+/// tail, e.g. jumps back to the head or to a loop latch outside, as memory
+/// references on that path are not scanned.
+bool MemOpt::getControlEquivalentRegion(
+    BasicBlock *Head, BasicBlock *Tail, const DenseSet<BasicBlock *> &Assigned,
+    SmallVectorImpl<BasicBlock *> &Region) const {
+  Region.clear();
+
+  SmallPtrSet<BasicBlock *, 16> Visited;
+  SmallVector<BasicBlock *, 16> WorkList;
+  Visited.insert(Head);
+  WorkList.push_back(Head);
+  while (!WorkList.empty()) {
+    BasicBlock *BB = WorkList.pop_back_val();
+    Region.push_back(BB);
+    if (Region.size() > MaxRegionBlocks)
+      return false;
+    if (BB == Tail)
+      continue;
+    for (auto *Succ : successors(BB)) {
+      if (Succ == Head || Assigned.count(Succ) ||
+          !DT->dominates(Head, Succ) || !PDT->dominates(Tail, Succ))
+        return false;
+      if (Visited.insert(Succ).second)
+        WorkList.push_back(Succ);
+    }
+  }
+
+  return true;
+}
+
 bool MemOpt::mergeLoad(LoadInst *LeadingLoad,
                        MemRefListTy::iterator MI, MemRefListTy& MemRefs,
                        TrivialMemRefListTy &ToOpt) {
@@ -539,6 +718,11 @@ bool MemOpt::mergeLoad(LoadInst *LeadingLoad,
     if (!NextLoad->isUnordered())
         break;
 
+    // Loads from BBs not control-equivalent to the leading one are only
+    // checked for dependency.
+    if (!isControlEquivalent(LeadingLoad, NextLoad))
+      continue;
+
     // Skip if that load is from different address spaces.
     if (NextLoad->getPointerAddressSpace() !=
         LeadingLoad->getPointerAddressSpace())
@@ -755,6 +939,14 @@ bool MemOpt::mergeLoad(LoadInst *LeadingLoad,
   Instruction *NewOne = NewLoad;
   std::swap(ToOpt.back(), NewOne);
 
+  NumLoadMsgEliminated += LoadsToMerge.size() - 1;
+  for (auto &I : LoadsToMerge) {
+    if (std::get<0>(I)->getParent() != LeadingLoad->getParent()) {
+      ++NumCrossBlockMerges;
+      break;
+    }
+  }
+
   for (auto &I : LoadsToMerge) {
     LoadInst *LD = cast<LoadInst>(std::get<0>(I));
     Value *Ptr = LD->getPointerOperand();
@@ -870,6 +1062,11 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
     if (!NextStore->isUnordered())
       break;
 
+    // Stores from BBs not control-equivalent to the leading one are only
+    // checked for dependency.
+    if (!isControlEquivalent(LeadingStore, NextStore))
+      continue;
+
     // Skip if that store is from different address spaces.
     if (NextStore->getPointerAddressSpace() !=
         LeadingStore->getPointerAddressSpace())
@@ -1059,6 +1256,14 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
   Instruction *NewOne = NewStore;
   std::swap(ToOpt.back(), NewOne);
 
+  NumStoreMsgEliminated += StoresToMerge.size() - 1;
+  for (auto &I : StoresToMerge) {
+    if (std::get<0>(I)->getParent() != TailingStore->getParent()) {
+      ++NumCrossBlockMerges;
+      break;
+    }
+  }
+
   for (auto &I : StoresToMerge) {
     StoreInst *ST = cast<StoreInst>(std::get<0>(I));
     Value *Ptr = ST->getPointerOperand();
@@ -38,6 +38,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Compiler/CISACodeGen/GenCodeGenModule.h"
 #include "Compiler/CISACodeGen/PushAnalysis.hpp"
+#include "Compiler/CISACodeGen/PushConstantProfile.hpp"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/PixelShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/CISACodeGen.h"
@@ -50,6 +51,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/debug/Debug.hpp"
 
 #include <list>
+#include <sstream>
 
 /***********************************************************************************
 This File contains the logic to decide for each inputs and constant if the data 
@@ -773,6 +775,17 @@ void PushAnalysis::BlockPushConstants()
     unsigned int sizePushed = 0;
     m_entryBB = &m_pFunction->getEntryBlock();
 
+    // the allocation below is greedy in program order; with a profile or on
+    // request, choose among all pushable constants instead. Only do so while
+    // nothing is pushed yet, as the ranges are chosen from scratch.
+    PushInfo &pushInfo = m_context->getModuleMetaData()->pushInfo;
+    if ((getPushConstantProfile() || IGC_IS_FLAG_ENABLED(EnablePushConstantKnapsack)) &&
+        pushInfo.simplePushBufferUsed == 0)
+    {
+        SelectPushedConstants(cthreshold);
+        return;
+    }
+
     // Runtime values are changed to intrinsics. So we need to do it before.
     for (auto bb = m_pFunction->begin(), be = m_pFunction->end(); bb != be; ++bb)
     {
@@ -790,6 +803,92 @@ void PushAnalysis::BlockPushConstants()
     }
 }
 
+void PushAnalysis::SelectPushedConstants(unsigned int maxSizeAllowed)
+{
+    PushInfo &pushInfo = m_context->getModuleMetaData()->pushInfo;
+    const PushConstantProfile* profile = getPushConstantProfile();
+    const QWORD hash = m_context->hash.getAsmHash();
+    const bool useProfile = profile && profile->hasShader(hash);
+
+    struct PushCandidate
+    {
+        Instruction* load;
+        unsigned int cbIdxOrGRFOffset;
+        unsigned int offset;
+        unsigned int size;
+        bool isStateless;
+    };
+    std::vector<PushCandidate> candidates;
+    std::vector<PushedConstantAccess> accesses;
+    uint64_t totalHits = 0;
+    for (auto bb = m_pFunction->begin(), be = m_pFunction->end(); bb != be; ++bb)
+    {
+        for (auto i = bb->begin(), ie = bb->end(); i != ie; ++i)
+        {
+            unsigned int cbIdOrGRFOffset = 0;
+            unsigned int offset = 0;
+            bool isStateless = false;
+            if (IsPushableShaderConstant(&(*i), cbIdOrGRFOffset, offset, isStateless))
+            {
+                unsigned int size = i->getType()->getPrimitiveSizeInBits() / 8;
+                // without a profile, every load is worth the same
+                uint64_t hits = useProfile ?
+                    profile->getAccessCount(hash, cbIdOrGRFOffset, offset, size) : 1;
+                candidates.push_back({ &(*i), cbIdOrGRFOffset, offset, size, isStateless });
+                accesses.push_back({ cbIdOrGRFOffset, offset / SIZE_GRF, iSTD::Round(offset + size, SIZE_GRF) / SIZE_GRF, hits });
+                totalHits += hits;
+            }
+        }
+    }
+
+    std::vector<PushedConstantRange> ranges = selectPushedConstantRanges(
+        accesses, maxSizeAllowed / SIZE_GRF, pushInfo.MaxNumberOfPushedBuffers);
+    for (auto& range : ranges)
+    {
+        SimplePushInfo &info = pushInfo.simplePushInfoArr[pushInfo.simplePushBufferUsed++];
+        info.cbIdx = range.buffer;
+        info.offset = range.startGRF * SIZE_GRF;
+        info.size = range.numGRFs * SIZE_GRF;
+    }
+
+    for (auto& candidate : candidates)
+    {
+        for (unsigned int piIndex = 0; piIndex < pushInfo.simplePushBufferUsed; piIndex++)
+        {
+            SimplePushInfo &info = pushInfo.simplePushInfoArr[piIndex];
+            if (info.cbIdx == candidate.cbIdxOrGRFOffset &&
+                candidate.offset >= info.offset &&
+                candidate.offset + candidate.size <= info.offset + info.size)
+            {
+                info.isStateless = candidate.isStateless;
+                PromoteLoadToSimplePush(candidate.load, info, candidate.offset);
+                break;
+            }
+        }
+    }
+
+    if (IGC_IS_FLAG_ENABLED(DumpPushConstantLayout))
+    {
+        uint64_t pushedHits = 0;
+        unsigned int pushedGRFs = 0;
+        std::stringstream report;
+        for (auto& range : ranges)
+        {
+            report << "    buffer " << range.buffer
+                << ": offset " << range.startGRF * SIZE_GRF
+                << ", " << range.numGRFs << " GRF, " << range.hits << " hits\n";
+            pushedHits += range.hits;
+            pushedGRFs += range.numGRFs;
+        }
+        std::stringstream header;
+        header << "shader " << std::hex << hash << std::dec
+            << " (" << (useProfile ? "profile" : "static") << "): "
+            << pushedGRFs << " of " << maxSizeAllowed / SIZE_GRF << " GRF, "
+            << pushedHits << " of " << totalHits << " hits pushed\n";
+        appendPushConstantLayout(header.str() + report.str());
+    }
+}
+
 PushConstantMode PushAnalysis::GetPushConstantMode()
 {
     PushConstantMode pushConstantMode = PushConstantMode::NO_PUSH_CONSTANT;
@@ -96,6 +96,10 @@ class PushAnalysis : public llvm::ModulePass
     /// process simple push for the function
     void BlockPushConstants();
 
+    /// choose the pushed ranges of all the pushable constants of the function
+    /// at once, weighting each load by its access frequency
+    void SelectPushedConstants(unsigned int maxSizeAllowed);
+
     /// Try to push allocate space for the constant to be pushed
     unsigned int AllocatePushedConstant(
         llvm::Instruction* load, unsigned int cbIdx, unsigned int offset, unsigned int maxSizeAllowed, bool isStateless);
@@ -0,0 +1,437 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "Compiler/CISACodeGen/PushConstantProfile.hpp"
+#include "common/igc_regkeys.hpp"
+#include "common/debug/Debug.hpp"
+#include "AdaptorCommon/customApi.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+using namespace IGC;
+
+namespace
+{
+    /// Just enough of JSON to read a profile: no escapes beyond \" and \\,
+    /// numbers are read as doubles.
+    struct JsonValue
+    {
+        enum Kind { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+        Kind kind = NUL;
+        double number = 0.0;
+        std::string str;
+        std::vector<JsonValue> elements;
+        std::vector<std::pair<std::string, JsonValue>> members;
+
+        const JsonValue* get(const std::string& name) const
+        {
+            for (auto& member : members)
+            {
+                if (member.first == name)
+                {
+                    return &member.second;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    class JsonReader
+    {
+    public:
+        explicit JsonReader(const std::string& text) : m_cur(text.c_str()), m_end(text.c_str() + text.size()) {}
+
+        bool parse(JsonValue& value)
+        {
+            if (!parseValue(value))
+            {
+                return false;
+            }
+            skipSpaces();
+            return m_cur == m_end;
+        }
+
+    private:
+        void skipSpaces()
+        {
+            while (m_cur != m_end && std::isspace(static_cast<unsigned char>(*m_cur)))
+            {
+                ++m_cur;
+            }
+        }
+
+        bool consume(char c)
+        {
+            skipSpaces();
+            if (m_cur != m_end && *m_cur == c)
+            {
+                ++m_cur;
+                return true;
+            }
+            return false;
+        }
+
+        bool consumeWord(const char* word)
+        {
+            const char* p = m_cur;
+            for (; *word; ++word, ++p)
+            {
+                if (p == m_end || *p != *word)
+                {
+                    return false;
+                }
+            }
+            m_cur = p;
+            return true;
+        }
+
+        bool parseString(std::string& str)
+        {
+            if (!consume('"'))
+            {
+                return false;
+            }
+            while (m_cur != m_end && *m_cur != '"')
+            {
+                if (*m_cur == '\\' && m_cur + 1 != m_end)
+                {
+                    ++m_cur;
+                }
+                str.push_back(*m_cur++);
+            }
+            return consume('"');
+        }
+
+        bool parseValue(JsonValue& value)
+        {
+            skipSpaces();
+            if (m_cur == m_end)
+            {
+                return false;
+            }
+            switch (*m_cur)
+            {
+            case '{':
+                value.kind = JsonValue::OBJECT;
+                ++m_cur;
+                if (consume('}'))
+                {
+                    return true;
+                }
+                do
+                {
+                    std::pair<std::string, JsonValue> member;
+                    if (!parseString(member.first) || !consume(':') || !parseValue(member.second))
+                    {
+                        return false;
+                    }
+                    value.members.push_back(std::move(member));
+                } while (consume(','));
+                return consume('}');
+            case '[':
+                value.kind = JsonValue::ARRAY;
+                ++m_cur;
+                if (consume(']'))
+                {
+                    return true;
+                }
+                do
+                {
+                    value.elements.emplace_back();
+                    if (!parseValue(value.elements.back()))
+                    {
+                        return false;
+                    }
+                } while (consume(','));
+                return consume(']');
+            case '"':
+                value.kind = JsonValue::STRING;
+                return parseString(value.str);
+            case 't':
+            case 'f':
+                value.kind = JsonValue::BOOLEAN;
+                value.number = *m_cur == 't' ? 1.0 : 0.0;
+                return consumeWord(*m_cur == 't' ? "true" : "false");
+            case 'n':
+                value.kind = JsonValue::NUL;
+                return consumeWord("null");
+            default:
+            {
+                // strtod stops at the first character that is not part of the number
+                std::string rest(m_cur, std::min<size_t>(m_end - m_cur, 64));
+                char* numEnd = nullptr;
+                value.kind = JsonValue::NUMBER;
+                value.number = std::strtod(rest.c_str(), &numEnd);
+                if (numEnd == rest.c_str())
+                {
+                    return false;
+                }
+                m_cur += numEnd - rest.c_str();
+                return true;
+            }
+            }
+        }
+
+        const char* m_cur;
+        const char* m_end;
+    };
+
+    bool getUnsigned(const JsonValue& object, const char* name, uint64_t& result)
+    {
+        const JsonValue* value = object.get(name);
+        if (!value || value->kind != JsonValue::NUMBER || value->number < 0.0)
+        {
+            return false;
+        }
+        result = static_cast<uint64_t>(value->number);
+        return true;
+    }
+}
+
+std::unique_ptr<PushConstantProfile> PushConstantProfile::create(const std::string& fileName)
+{
+    std::ifstream is(fileName);
+    if (!is.is_open())
+    {
+        return nullptr;
+    }
+    std::stringstream text;
+    text << is.rdbuf();
+
+    JsonValue root;
+    if (!JsonReader(text.str()).parse(root) || root.kind != JsonValue::OBJECT)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<PushConstantProfile> profile(new PushConstantProfile());
+    for (auto& shader : root.members)
+    {
+        char* hashEnd = nullptr;
+        QWORD hash = std::strtoull(shader.first.c_str(), &hashEnd, 16);
+        if (shader.first.empty() || *hashEnd != '\0' || shader.second.kind != JsonValue::ARRAY)
+        {
+            return nullptr;
+        }
+        AccessCountMap& counts = profile->m_shaders[hash];
+        for (auto& access : shader.second.elements)
+        {
+            uint64_t buffer = 0, offset = 0, count = 0;
+            if (access.kind != JsonValue::OBJECT ||
+                !getUnsigned(access, "buffer", buffer) ||
+                !getUnsigned(access, "offset", offset) ||
+                !getUnsigned(access, "count", count))
+            {
+                return nullptr;
+            }
+            counts[std::make_pair(unsigned(buffer), unsigned(offset))] += count;
+        }
+    }
+    return profile;
+}
+
+uint64_t PushConstantProfile::getAccessCount(QWORD hash, unsigned buffer, unsigned offset, unsigned size) const
+{
+    auto shader = m_shaders.find(hash);
+    if (shader == m_shaders.end())
+    {
+        return 0;
+    }
+    uint64_t count = 0;
+    auto it = shader->second.lower_bound(std::make_pair(buffer, offset));
+    auto end = shader->second.lower_bound(std::make_pair(buffer, offset + size));
+    for (; it != end; ++it)
+    {
+        count = std::max(count, it->second);
+    }
+    return count;
+}
+
+const PushConstantProfile* IGC::getPushConstantProfile()
+{
+    const char* fileName = IGC_GET_REGKEYSTRING(PushConstantProfileFile);
+    if (fileName == nullptr || fileName[0] == '\0')
+    {
+        return nullptr;
+    }
+
+    static std::once_flag loaded;
+    static std::unique_ptr<PushConstantProfile> profile;
+    std::call_once(loaded, [fileName]() {
+        profile = PushConstantProfile::create(fileName);
+        if (!profile)
+        {
+            assert(0 && "cannot load push constant profile");
+        }
+    });
+    return profile.get();
+}
+
+std::vector<PushedConstantRange> IGC::selectPushedConstantRanges(
+    const std::vector<PushedConstantAccess>& accesses,
+    unsigned maxGRFs,
+    unsigned maxRanges)
+{
+    std::map<unsigned, std::vector<const PushedConstantAccess*>> accessesPerBuffer;
+    for (auto& access : accesses)
+    {
+        if (access.hits > 0 &&
+            access.endGRF > access.startGRF &&
+            access.endGRF - access.startGRF <= maxGRFs)
+        {
+            accessesPerBuffer[access.buffer].push_back(&access);
+        }
+    }
+
+    // The best range of each size in each buffer. Ranges worth considering
+    // start where an access starts and end where an access ends.
+    struct Option
+    {
+        unsigned startGRF;
+        uint64_t hits;
+    };
+    std::vector<unsigned> buffers;
+    std::vector<std::vector<Option>> options;
+    for (auto& it : accessesPerBuffer)
+    {
+        // Profiles record the same access many times, so merge them by GRF
+        // range first. Accesses are indexed by the GRF they end at; each of
+        // them starts less than maxGRFs before that.
+        std::set<unsigned> starts;
+        std::map<unsigned, std::map<unsigned, uint64_t>> hitsByEnd;
+        for (auto* access : it.second)
+        {
+            starts.insert(access->startGRF);
+            hitsByEnd[access->endGRF][access->startGRF] += access->hits;
+        }
+
+        // Grow a range from each start one GRF at a time, adding the
+        // accesses that end at its new end.
+        std::vector<Option> best(maxGRFs + 1, Option{ 0, 0 });
+        for (unsigned start : starts)
+        {
+            uint64_t hits = 0;
+            for (unsigned n = 1; n <= maxGRFs; ++n)
+            {
+                auto ending = hitsByEnd.find(start + n);
+                if (ending == hitsByEnd.end())
+                {
+                    continue;
+                }
+                for (auto sit = ending->second.lower_bound(start); sit != ending->second.end(); ++sit)
+                {
+                    hits += sit->second;
+                }
+                Option& option = best[n];
+                if (hits > option.hits || (hits == option.hits && start < option.startGRF))
+                {
+                    option = Option{ start, hits };
+                }
+            }
+        }
+        buffers.push_back(it.first);
+        options.push_back(std::move(best));
+    }
+
+    // Grouped knapsack over the buffers: hits[r][w] is the best number of
+    // hits with r ranges of w GRFs in total, -1 if not reachable, and
+    // choice[b][r][w] the size of the range taken from buffer b to get there.
+    const unsigned numStates = (maxRanges + 1) * (maxGRFs + 1);
+    auto state = [maxGRFs](unsigned r, unsigned w) { return r * (maxGRFs + 1) + w; };
+    std::vector<int64_t> hits(numStates, -1);
+    std::vector<std::vector<unsigned>> choice(buffers.size(), std::vector<unsigned>(numStates, 0));
+    hits[state(0, 0)] = 0;
+    for (unsigned b = 0; b < buffers.size(); ++b)
+    {
+        std::vector<int64_t> newHits = hits;
+        for (unsigned r = 0; r < maxRanges; ++r)
+        {
+            for (unsigned w = 0; w <= maxGRFs; ++w)
+            {
+                if (hits[state(r, w)] < 0)
+                {
+                    continue;
+                }
+                for (unsigned n = 1; w + n <= maxGRFs; ++n)
+                {
+                    if (options[b][n].hits == 0)
+                    {
+                        continue;
+                    }
+                    int64_t candidate = hits[state(r, w)] + int64_t(options[b][n].hits);
+                    if (candidate > newHits[state(r + 1, w + n)])
+                    {
+                        newHits[state(r + 1, w + n)] = candidate;
+                        choice[b][state(r + 1, w + n)] = n;
+                    }
+                }
+            }
+        }
+        hits.swap(newHits);
+    }
+
+    unsigned bestR = 0, bestW = 0;
+    for (unsigned r = 0; r <= maxRanges; ++r)
+    {
+        for (unsigned w = 0; w <= maxGRFs; ++w)
+        {
+            int64_t h = hits[state(r, w)];
+            int64_t best = hits[state(bestR, bestW)];
+            if (h > best || (h == best && h >= 0 && w < bestW))
+            {
+                bestR = r;
+                bestW = w;
+            }
+        }
+    }
+
+    std::vector<PushedConstantRange> ranges;
+    for (unsigned b = buffers.size(); b-- > 0;)
+    {
+        unsigned n = choice[b][state(bestR, bestW)];
+        if (n == 0)
+        {
+            continue;
+        }
+        ranges.push_back(PushedConstantRange{ buffers[b], options[b][n].startGRF, n, options[b][n].hits });
+        --bestR;
+        bestW -= n;
+    }
+    std::reverse(ranges.begin(), ranges.end());
+    return ranges;
+}
+
+void IGC::appendPushConstantLayout(const std::string& report)
+{
+    IGC::Debug::AppendToDumpFile("PushConstantLayout.txt", report);
+}
@@ -0,0 +1,105 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include "common/Types.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace IGC
+{
+    /// Access frequencies of pushable constants, per shader, read from a
+    /// JSON file of the form
+    ///     {
+    ///         "0x0123456789abcdef": [
+    ///             { "buffer": 0, "offset": 64, "count": 1200 },
+    ///             ...
+    ///         ],
+    ///         ...
+    ///     }
+    /// The keys are shader asm hashes. "buffer" is the constant buffer id,
+    /// or the GRF offset of the base address for stateless buffers, and
+    /// "offset" is the byte offset of the accessed dword in that buffer.
+    class PushConstantProfile
+    {
+    public:
+        /// Returns nullptr if the file cannot be read or is malformed.
+        static std::unique_ptr<PushConstantProfile> create(const std::string& fileName);
+
+        bool hasShader(QWORD hash) const { return m_shaders.count(hash) != 0; }
+
+        /// Highest access count of the dwords in [offset, offset + size)
+        /// of the buffer, 0 if none of them was accessed.
+        uint64_t getAccessCount(QWORD hash, unsigned buffer, unsigned offset, unsigned size) const;
+
+    private:
+        PushConstantProfile() {}
+
+        // buffer and byte offset to access count, per shader hash
+        typedef std::map<std::pair<unsigned, unsigned>, uint64_t> AccessCountMap;
+        std::map<QWORD, AccessCountMap> m_shaders;
+    };
+
+    /// Returns the profile selected by the PushConstantProfileFile regkey,
+    /// or nullptr if none is set. The file is read once per process.
+    const PushConstantProfile* getPushConstantProfile();
+
+    /// A constant load that could be pushed, in GRF units of its buffer.
+    struct PushedConstantAccess
+    {
+        unsigned buffer;
+        unsigned startGRF;
+        unsigned endGRF;    // exclusive
+        uint64_t hits;
+    };
+
+    /// A contiguous range of GRFs pushed from one buffer.
+    struct PushedConstantRange
+    {
+        unsigned buffer;
+        unsigned startGRF;
+        unsigned numGRFs;
+        uint64_t hits;
+    };
+
+    /// Chooses at most one range per buffer and at most maxRanges ranges
+    /// in total, covering at most maxGRFs GRFs, so that the hits of the
+    /// accesses lying entirely in the chosen ranges are maximal. Among
+    /// equally good layouts the one with the fewest GRFs is chosen.
+    std::vector<PushedConstantRange> selectPushedConstantRanges(
+        const std::vector<PushedConstantAccess>& accesses,
+        unsigned maxGRFs,
+        unsigned maxRanges);
+
+    /// Appends the report of a chosen layout to PushConstantLayout.txt in
+    /// the shader dump folder.
+    void appendPushConstantLayout(const std::string& report);
+
+} // namespace IGC
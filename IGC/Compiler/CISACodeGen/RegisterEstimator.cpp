@@ -41,6 +41,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/Support/MathExtras.h>
@@ -628,4 +629,82 @@ void RegisterEstimator::dump(BasicBlock *BB, int dumpLevel)
     print(dbgs(), BB, dumpLevel);
 }
 
-#endif
\ No newline at end of file
+#endif
+
+bool LiveOutPressureTracker::isUsedOutside(Instruction *I) const
+{
+    for (auto UI = I->use_begin(), UE = I->use_end(); UI != UE; ++UI)
+    {
+        Instruction *user = cast<Instruction>(UI->getUser());
+        if (PHINode *PN = dyn_cast<PHINode>(user))
+        {
+            // PHI nodes use the operand in the predecessor block,
+            // not the block with the PHI.
+            if (PN->getIncomingBlock(*UI) != m_BB)
+                return true;
+        }
+        else if (user->getParent() != m_BB)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t LiveOutPressureTracker::getSize(Instruction *I) const
+{
+    return (uint32_t)m_DL->getTypeAllocSize(I->getType());
+}
+
+void LiveOutPressureTracker::init(BasicBlock *BB)
+{
+    m_BB = BB;
+    m_Pressure = 0;
+    m_LiveOut.clear();
+    for (auto &I : *BB)
+    {
+        if (isa<DbgInfoIntrinsic>(&I) || I.use_empty())
+            continue;
+        if (isUsedOutside(&I))
+        {
+            m_LiveOut.insert(&I);
+            m_Pressure += getSize(&I);
+        }
+    }
+}
+
+template <typename Fn>
+void LiveOutPressureTracker::forEachNewLiveOut(Instruction *I, Fn fn) const
+{
+    SmallPtrSet<Instruction*, 8> seen;
+    for (Value *Op : I->operands())
+    {
+        Instruction *def = dyn_cast<Instruction>(Op);
+        if (def && def != I && def->getParent() == m_BB &&
+            !m_LiveOut.count(def) && seen.insert(def).second)
+        {
+            fn(def);
+        }
+    }
+}
+
+uint32_t LiveOutPressureTracker::getPressureIfMovedOut(Instruction *I) const
+{
+    uint32_t pressure = m_Pressure;
+    if (m_LiveOut.count(I))
+        pressure -= getSize(I);
+    forEachNewLiveOut(I, [&](Instruction *def) { pressure += getSize(def); });
+    return pressure;
+}
+
+void LiveOutPressureTracker::instructionMovedOut(Instruction *I)
+{
+    assert(I->getParent() != m_BB && "instruction is still in the tracked BB");
+    if (m_LiveOut.erase(I))
+        m_Pressure -= getSize(I);
+    // Operands defined in the BB are now used from I's new block.
+    forEachNewLiveOut(I, [&](Instruction *def) {
+        m_LiveOut.insert(def);
+        m_Pressure += getSize(def);
+    });
+}
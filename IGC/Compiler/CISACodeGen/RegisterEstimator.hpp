@@ -32,11 +32,13 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SparseBitVector.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Value.h"
+#include "llvm/Analysis/LoopInfo.h"
 #include "common/LLVMWarningsPop.hpp"
 
 namespace IGC
@@ -223,6 +225,15 @@ namespace IGC
             return getNumRegs(grfuse, simdsize);
         }
 
+        // Return the max number of GRF needed in any BB of a loop
+        uint32_t getMaxLiveGRFAtLoop(llvm::Loop *L, uint16_t simdsize = 16) {
+            uint32_t maxGRF = 0;
+            for (llvm::BasicBlock *BB : L->blocks()) {
+                maxGRF = std::max(maxGRF, getMaxLiveGRFAtBB(BB, simdsize));
+            }
+            return maxGRF;
+        }
+
         uint32_t getNumValues() const {
             return (uint32_t)m_ValueRegUses.capacity();
         }
@@ -380,4 +391,37 @@ namespace IGC
         // accurate live information.
         llvm::DenseMap<llvm::Value*, int> m_DeadValueNumUses;
     };
+
+    // Tracks the bytes of values that are defined in a BB and used outside
+    // of it. Unlike RegPressureTracker it needs no liveness, so code motion
+    // passes can use it cheaply. init() walks the BB once; after that the
+    // estimate is kept current as instructions are moved out of the BB, and
+    // the effect of a move can be queried before doing it.
+    class LiveOutPressureTracker {
+    public:
+        explicit LiveOutPressureTracker(const llvm::DataLayout *DL) :
+            m_DL(DL), m_BB(nullptr), m_Pressure(0) {}
+
+        void init(llvm::BasicBlock *BB);
+
+        // Update the estimate after I has been moved from the tracked BB
+        // into another one.
+        void instructionMovedOut(llvm::Instruction *I);
+
+        // The estimate if I were moved out of the tracked BB.
+        uint32_t getPressureIfMovedOut(llvm::Instruction *I) const;
+
+        uint32_t getPressure() const { return m_Pressure; }
+
+    private:
+        const llvm::DataLayout *m_DL;
+        llvm::BasicBlock *m_BB;
+        uint32_t m_Pressure;
+        llvm::SmallPtrSet<llvm::Instruction*, 32> m_LiveOut;
+
+        bool isUsedOutside(llvm::Instruction *I) const;
+        uint32_t getSize(llvm::Instruction *I) const;
+        // Operands of I that become live-out when I leaves the tracked BB.
+        template <typename Fn> void forEachNewLiveOut(llvm::Instruction *I, Fn fn) const;
+    };
 }
@@ -1000,6 +1000,11 @@ void OptimizeIR(CodeGenContext* pContext)
         return;
     }
 
+    // Function passes below run one function at a time, but they must not be
+    // spread across threads: all functions share one LLVMContext, and constant,
+    // type and metadata uniquing in it is not thread-safe. Multi-kernel modules
+    // would have to be split into per-context modules first, which loses the
+    // Function*-keyed MetaDataUtils/ModuleMetaData the passes rely on.
     IGCPassManager mpm(pContext, "OPT");
 
 #if defined( _DEBUG )
@@ -394,6 +394,9 @@ protected:
     llvm::DenseMap<CoalescingEngine::CCTuple*, CVariable*> ccTupleMapping;
     // Constant pool.
     llvm::DenseMap<llvm::Constant *, CVariable *> ConstantPool;
+    // Bitcast aliases already created for a (variable, type) pair, so that
+    // repeated BitCast() calls reuse the same CVariable.
+    llvm::DenseMap<std::pair<CVariable*, unsigned>, CVariable*> bitCastMapping;
 
     // keep a map when we generate accurate mask for vector value
     // in order to reduce register usage
@@ -34,6 +34,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Operator.h>
 #include "common/LLVMWarningsPop.hpp"
+#include <sstream>
 #include "GenISAIntrinsics/GenIntrinsics.h"
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
 
@@ -51,6 +52,7 @@ IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
 IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
 IGC_INITIALIZE_PASS_END(Simd32ProfitabilityAnalysis, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char Simd32ProfitabilityAnalysis::ID = 0;
@@ -553,6 +555,11 @@ bool Simd32ProfitabilityAnalysis::runOnFunction(Function &F)
         pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
         m_isSimd16Profitable = checkSimd16Profitable(context);
         m_isSimd32Profitable = m_isSimd16Profitable && checkSimd32Profitable(context);
+        if (needsCostFeatures())
+        {
+            computeCostFeatures();
+            applySimdCostModel(context);
+        }
     }
     else if(context->type == ShaderType::PIXEL_SHADER)
     {
@@ -1204,3 +1211,95 @@ bool Simd32ProfitabilityAnalysis::checkPSSimd32Profitable()
     }
     return false;
 }
+
+bool Simd32ProfitabilityAnalysis::needsCostFeatures()
+{
+    return IGC_IS_FLAG_ENABLED(DumpSIMDCostModelData) ||
+        getSimdCostModel() != nullptr;
+}
+
+void Simd32ProfitabilityAnalysis::computeCostFeatures()
+{
+    unsigned numInsts = 0, numBlocks = 0, numMemory = 0, numSample = 0;
+    unsigned numDouble = 0, numDivergentBranches = 0;
+    for (auto &BB : *F) {
+        ++numBlocks;
+        for (auto &I : BB) {
+            ++numInsts;
+            if (isSampleLoadGather4InfoInstruction(&I))
+                ++numSample;
+            else if (I.mayReadOrWriteMemory())
+                ++numMemory;
+            if (I.getType()->isDoubleTy())
+                ++numDouble;
+        }
+        auto Br = dyn_cast<BranchInst>(BB.getTerminator());
+        if (Br && Br->isConditional() &&
+            WI->whichDepend(Br) != WIAnalysis::UNIFORM)
+            ++numDivergentBranches;
+    }
+
+    unsigned numLoops = 0, maxLoopDepth = 0;
+    SmallVector<Loop *, 16> Worklist(LI->begin(), LI->end());
+    while (!Worklist.empty()) {
+        Loop *L = Worklist.pop_back_val();
+        ++numLoops;
+        maxLoopDepth = std::max(maxLoopDepth, L->getLoopDepth());
+        Worklist.append(L->begin(), L->end());
+    }
+
+    RegisterEstimator &RPE = getAnalysis<RegisterEstimator>();
+    RPE.calculate();
+    unsigned maxGRF = 0;
+    for (auto &BB : *F)
+        maxGRF = std::max(maxGRF, RPE.getMaxLiveGRFAtBB(&BB, 16));
+
+    float *value = m_costFeatures.value;
+    float insts = (float)std::max(numInsts, 1U);
+    value[SimdCostFeatures::NUM_INSTRUCTIONS] = (float)numInsts;
+    value[SimdCostFeatures::NUM_BLOCKS] = (float)numBlocks;
+    value[SimdCostFeatures::NUM_LOOPS] = (float)numLoops;
+    value[SimdCostFeatures::MAX_LOOP_DEPTH] = (float)maxLoopDepth;
+    value[SimdCostFeatures::LOOP_CYCLOMATIC_COMPLEXITY] = (float)getLoopCyclomaticComplexity();
+    value[SimdCostFeatures::MEMORY_RATIO] = numMemory / insts;
+    value[SimdCostFeatures::SAMPLE_RATIO] = numSample / insts;
+    value[SimdCostFeatures::DIVERGENT_BRANCH_RATIO] = numDivergentBranches / (float)numBlocks;
+    value[SimdCostFeatures::DOUBLE_RATIO] = numDouble / insts;
+    value[SimdCostFeatures::MAX_GRF_PRESSURE_SIMD16] = (float)maxGRF;
+}
+
+// Heuristics above decide which widths are worth trying; the cost model can
+// only take a width away, so a bad weights file never forces a compile that
+// the heuristics rejected.
+void Simd32ProfitabilityAnalysis::applySimdCostModel(CodeGenContext *ctx)
+{
+    if (IGC_IS_FLAG_ENABLED(DumpSIMDCostModelData)) {
+        std::ostringstream record;
+        record << std::hex << ctx->hash.getAsmHash() << std::dec << ","
+               << F->getName().str();
+        for (float v : m_costFeatures.value)
+            record << "," << v;
+        appendSimdCostModelRecord("SIMDCostFeatures.csv", record.str());
+    }
+
+    const SimdCostModel *model = getSimdCostModel();
+    if (!model)
+        return;
+
+    const float threshold =
+        IGC_GET_FLAG_VALUE(SIMDCostModelSpillThreshold) / 100.0f;
+    auto isDoomed = [&](SIMDMode mode, SIMDMode narrower) {
+        float spill = model->predictSpill(m_costFeatures, mode);
+        if (spill >= 0.0f && spill >= threshold)
+            return true;
+        float wide = model->predictThroughput(m_costFeatures, mode);
+        float narrow = model->predictThroughput(m_costFeatures, narrower);
+        return wide >= 0.0f && narrow >= 0.0f && wide <= narrow;
+    };
+
+    if (m_isSimd16Profitable && isDoomed(SIMDMode::SIMD16, SIMDMode::SIMD8))
+        m_isSimd16Profitable = false;
+    if (m_isSimd32Profitable &&
+        (!m_isSimd16Profitable || isDoomed(SIMDMode::SIMD32, SIMDMode::SIMD16)))
+        m_isSimd32Profitable = false;
+}
@@ -32,6 +32,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
+#include "Compiler/CISACodeGen/SimdCostModel.hpp"
 
 namespace IGC
 {
@@ -64,10 +66,15 @@ namespace IGC
             AU.addRequired<llvm::PostDominatorTreeWrapperPass>();
             AU.addRequired<MetaDataUtilsWrapper>();
             AU.addRequired<CodeGenContextWrapper>();
+            if (needsCostFeatures())
+            {
+                AU.addRequired<RegisterEstimator>();
+            }
         }
 
         bool isSimd32Profitable() const { return m_isSimd32Profitable; }
         bool isSimd16Profitable() const { return m_isSimd16Profitable; }
+        const SimdCostFeatures& getCostFeatures() const { return m_costFeatures; }
 
     private:
         llvm::Function *F;
@@ -77,6 +84,7 @@ namespace IGC
         WIAnalysis *WI;
         bool m_isSimd32Profitable;
         bool m_isSimd16Profitable;
+        SimdCostFeatures m_costFeatures;
 
         unsigned getLoopCyclomaticComplexity();
         bool checkSimd32Profitable(CodeGenContext *);
@@ -89,6 +97,10 @@ namespace IGC
         bool isSelectBasedOnGlobalIdX(llvm::Value *);
 
         bool checkPSSimd32Profitable();
+
+        static bool needsCostFeatures();
+        void computeCostFeatures();
+        void applySimdCostModel(CodeGenContext *);
     };
 
 } // namespace IGC
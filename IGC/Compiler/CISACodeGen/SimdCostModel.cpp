@@ -0,0 +1,180 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "Compiler/CISACodeGen/SimdCostModel.hpp"
+#include "common/igc_regkeys.hpp"
+#include "common/debug/Debug.hpp"
+#include "AdaptorCommon/customApi.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+using namespace IGC;
+
+const char* SimdCostFeatures::getName(Kind kind)
+{
+    switch (kind)
+    {
+    case NUM_INSTRUCTIONS:           return "NumInstructions";
+    case NUM_BLOCKS:                 return "NumBlocks";
+    case NUM_LOOPS:                  return "NumLoops";
+    case MAX_LOOP_DEPTH:             return "MaxLoopDepth";
+    case LOOP_CYCLOMATIC_COMPLEXITY: return "LoopCyclomaticComplexity";
+    case MEMORY_RATIO:               return "MemoryRatio";
+    case SAMPLE_RATIO:               return "SampleRatio";
+    case DIVERGENT_BRANCH_RATIO:     return "DivergentBranchRatio";
+    case DOUBLE_RATIO:               return "DoubleRatio";
+    case MAX_GRF_PRESSURE_SIMD16:    return "MaxGRFPressureSIMD16";
+    default:
+        assert(0 && "unknown SIMD cost feature");
+        return "";
+    }
+}
+
+std::unique_ptr<LinearSimdCostModel> LinearSimdCostModel::create(const std::string& fileName)
+{
+    std::ifstream is(fileName);
+    if (!is.is_open())
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<LinearSimdCostModel> model(new LinearSimdCostModel());
+    std::string line;
+    while (std::getline(is, line))
+    {
+        std::istringstream ss(line);
+        unsigned simd = 0;
+        std::string target;
+        if (!(ss >> simd))
+        {
+            // blank line or comment
+            continue;
+        }
+        if (!(ss >> target))
+        {
+            return nullptr;
+        }
+
+        Weights weights;
+        ss >> weights.bias;
+        for (unsigned i = 0; i < SimdCostFeatures::NUM_FEATURES; ++i)
+        {
+            ss >> weights.w[i];
+        }
+        if (ss.fail())
+        {
+            return nullptr;
+        }
+        weights.valid = true;
+
+        Target t = target == "spill" ? SPILL : target == "throughput" ? THROUGHPUT : NUM_TARGETS;
+        unsigned width = simd == 8 ? 0 : simd == 16 ? 1 : simd == 32 ? 2 : NUM_WIDTHS;
+        if (t == NUM_TARGETS || width == NUM_WIDTHS)
+        {
+            return nullptr;
+        }
+        model->m_weights[t][width] = weights;
+    }
+    return model;
+}
+
+const LinearSimdCostModel::Weights* LinearSimdCostModel::getWeights(Target target, SIMDMode mode) const
+{
+    unsigned width = NUM_WIDTHS;
+    switch (mode)
+    {
+    case SIMDMode::SIMD8:  width = 0; break;
+    case SIMDMode::SIMD16: width = 1; break;
+    case SIMDMode::SIMD32: width = 2; break;
+    default: break;
+    }
+    if (width == NUM_WIDTHS || !m_weights[target][width].valid)
+    {
+        return nullptr;
+    }
+    return &m_weights[target][width];
+}
+
+static float evaluate(const float* w, float bias, const SimdCostFeatures& features)
+{
+    float sum = bias;
+    for (unsigned i = 0; i < SimdCostFeatures::NUM_FEATURES; ++i)
+    {
+        sum += w[i] * features.value[i];
+    }
+    return sum;
+}
+
+float LinearSimdCostModel::predictSpill(const SimdCostFeatures& features, SIMDMode mode) const
+{
+    const Weights* weights = getWeights(SPILL, mode);
+    if (!weights)
+    {
+        return -1.0f;
+    }
+    float x = evaluate(weights->w, weights->bias, features);
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+float LinearSimdCostModel::predictThroughput(const SimdCostFeatures& features, SIMDMode mode) const
+{
+    const Weights* weights = getWeights(THROUGHPUT, mode);
+    if (!weights)
+    {
+        return -1.0f;
+    }
+    return std::max(0.0f, evaluate(weights->w, weights->bias, features));
+}
+
+const SimdCostModel* IGC::getSimdCostModel()
+{
+    const char* fileName = IGC_GET_REGKEYSTRING(SIMDCostModelFile);
+    if (fileName == nullptr || fileName[0] == '\0')
+    {
+        return nullptr;
+    }
+
+    static std::once_flag loaded;
+    static std::unique_ptr<LinearSimdCostModel> model;
+    std::call_once(loaded, [fileName]() {
+        model = LinearSimdCostModel::create(fileName);
+        if (!model)
+        {
+            assert(0 && "cannot load SIMD cost model weights");
+        }
+    });
+    return model.get();
+}
+
+void IGC::appendSimdCostModelRecord(const char* fileName, const std::string& record)
+{
+    IGC::Debug::AppendToDumpFile(fileName, record + "\n");
+}
@@ -0,0 +1,116 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include "common/Types.hpp"
+
+#include <memory>
+#include <string>
+
+namespace IGC
+{
+    /// Per-function features used to predict how a kernel behaves at a
+    /// given SIMD width before it is compiled. The order of the entries in
+    /// SimdCostFeatures::Kind is the order of the weights in a model file.
+    struct SimdCostFeatures
+    {
+        enum Kind
+        {
+            NUM_INSTRUCTIONS,
+            NUM_BLOCKS,
+            NUM_LOOPS,
+            MAX_LOOP_DEPTH,
+            LOOP_CYCLOMATIC_COMPLEXITY,
+            MEMORY_RATIO,        // loads, stores and other memory accesses
+            SAMPLE_RATIO,        // sample, load, gather4 and info messages
+            DIVERGENT_BRANCH_RATIO,
+            DOUBLE_RATIO,
+            MAX_GRF_PRESSURE_SIMD16,
+            NUM_FEATURES
+        };
+
+        float value[NUM_FEATURES] = {};
+
+        static const char* getName(Kind kind);
+    };
+
+    /// Interface of a model that predicts, before code generation, whether
+    /// a SIMD width is worth compiling.
+    class SimdCostModel
+    {
+    public:
+        virtual ~SimdCostModel() {}
+
+        /// Probability in [0, 1] that the kernel spills at the given width,
+        /// or a negative value if the model has no prediction for it.
+        virtual float predictSpill(const SimdCostFeatures& features, SIMDMode mode) const = 0;
+
+        /// Relative throughput at the given width, only meaningful compared
+        /// to the prediction for another width. Negative if unknown.
+        virtual float predictThroughput(const SimdCostFeatures& features, SIMDMode mode) const = 0;
+    };
+
+    /// Linear model with weights read from a text file. Each non-comment
+    /// line holds
+    ///     <simd width> <spill|throughput> <bias> <weight>...
+    /// with one weight per SimdCostFeatures::Kind. Spill predictions go
+    /// through a logistic function; throughput predictions are used as is.
+    class LinearSimdCostModel : public SimdCostModel
+    {
+    public:
+        /// Returns nullptr if the file cannot be read or is malformed.
+        static std::unique_ptr<LinearSimdCostModel> create(const std::string& fileName);
+
+        float predictSpill(const SimdCostFeatures& features, SIMDMode mode) const override;
+        float predictThroughput(const SimdCostFeatures& features, SIMDMode mode) const override;
+
+    private:
+        enum Target { SPILL, THROUGHPUT, NUM_TARGETS };
+        enum { NUM_WIDTHS = 3 }; // SIMD8, SIMD16, SIMD32
+
+        struct Weights
+        {
+            bool valid = false;
+            float bias = 0.0f;
+            float w[SimdCostFeatures::NUM_FEATURES] = {};
+        };
+
+        LinearSimdCostModel() {}
+
+        const Weights* getWeights(Target target, SIMDMode mode) const;
+
+        Weights m_weights[NUM_TARGETS][NUM_WIDTHS];
+    };
+
+    /// Returns the model selected by the SIMDCostModelFile regkey, or
+    /// nullptr if none is set. The file is read once per process.
+    const SimdCostModel* getSimdCostModel();
+
+    /// Appends a line to the given file in the shader dump folder. Used
+    /// with DumpSIMDCostModelData to collect training data for the model.
+    void appendSimdCostModelRecord(const char* fileName, const std::string& record);
+
+} // namespace IGC
@@ -1211,5 +1211,11 @@ bool valueIsPositive(
     return isKnownPositive;
 }
 
+uint64_t getLoopFrequencyWeight(const LoopInfo& LI, const BasicBlock* BB)
+{
+    unsigned depth = std::min(LI.getLoopDepth(BB), 6u);
+    return uint64_t(1) << (3 * depth);
+}
+
 
 } // namespace IGC
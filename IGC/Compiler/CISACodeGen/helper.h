@@ -39,6 +39,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/PassManager.h>
+#include <llvm/Analysis/LoopInfo.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "GenISAIntrinsics/GenIntrinsics.h"
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
@@ -287,6 +288,10 @@ bool valueIsPositive(
 	llvm::AssumptionCache *AC = nullptr,
 	llvm::Instruction *CxtI = nullptr);
 
+/// Estimated number of times BB runs per run of its function: a factor of 8
+/// for each enclosing loop, up to a loop depth of 6.
+uint64_t getLoopFrequencyWeight(const llvm::LoopInfo& LI, const llvm::BasicBlock* BB);
+
 inline float GetThreadOccupancyPerSubslice(SIMDMode simdMode, unsigned threadGroupSize, unsigned hwThreadPerSubslice, unsigned slmSize, unsigned slmSizePerSubSlice)
 {
     unsigned simdWidth = 8;
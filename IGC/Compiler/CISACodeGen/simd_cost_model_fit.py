@@ -0,0 +1,141 @@
+#===================== begin_copyright_notice ==================================
+
+#Copyright (c) 2017 Intel Corporation
+
+#Permission is hereby granted, free of charge, to any person obtaining a
+#copy of this software and associated documentation files (the
+#"Software"), to deal in the Software without restriction, including
+#without limitation the rights to use, copy, modify, merge, publish,
+#distribute, sublicense, and/or sell copies of the Software, and to
+#permit persons to whom the Software is furnished to do so, subject to
+#the following conditions:
+
+#The above copyright notice and this permission notice shall be included
+#in all copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+#MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+#IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+#CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+#TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+#SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#======================= end_copyright_notice ==================================
+
+# Fits the weights of the linear SIMD cost model (SimdCostModel.hpp) from the
+# files written by a compile run with DumpSIMDCostModelData enabled:
+#   SIMDCostFeatures.csv  hash,kernel,<one column per SimdCostFeatures::Kind>
+#   SIMDCostOutcomes.csv  hash,kernel,simd,spilled,asmCount,staticCycles
+# and writes a weights file to pass in the SIMDCostModelFile regkey.
+#
+# Spill weights come from logistic regression on the spilled flag. Throughput
+# weights come from ridge regression on work items per static cycle.
+#
+# usage: simd_cost_model_fit.py <dump folder> <weights file>
+
+import csv
+import math
+import os
+import sys
+
+NUM_FEATURES = 10
+
+def read_rows(path):
+    with open(path) as f:
+        return [row for row in csv.reader(f) if row]
+
+def standardize(xs):
+    n = len(xs[0])
+    mean = [sum(x[i] for x in xs) / len(xs) for i in range(n)]
+    std = [math.sqrt(sum((x[i] - mean[i]) ** 2 for x in xs) / len(xs)) or 1.0 for i in range(n)]
+    zs = [[(x[i] - mean[i]) / std[i] for i in range(n)] for x in xs]
+    return zs, mean, std
+
+def unstandardize(bias, w, mean, std):
+    # w.z + b == sum(w_i / std_i * x_i) + b - sum(w_i * mean_i / std_i)
+    raw = [w[i] / std[i] for i in range(len(w))]
+    return bias - sum(raw[i] * mean[i] for i in range(len(w))), raw
+
+def fit_logistic(xs, ys, iterations=2000, rate=0.1, l2=1e-3):
+    zs, mean, std = standardize(xs)
+    n = len(zs[0])
+    w = [0.0] * n
+    b = 0.0
+    for _ in range(iterations):
+        gw = [0.0] * n
+        gb = 0.0
+        for z, y in zip(zs, ys):
+            t = b + sum(wi * zi for wi, zi in zip(w, z))
+            p = 1.0 / (1.0 + math.exp(-max(min(t, 30.0), -30.0)))
+            for i in range(n):
+                gw[i] += (p - y) * z[i]
+            gb += p - y
+        w = [wi - rate * (g / len(zs) + l2 * wi) for wi, g in zip(w, gw)]
+        b -= rate * gb / len(zs)
+    return unstandardize(b, w, mean, std)
+
+def solve(a, v):
+    # Gaussian elimination with partial pivoting.
+    n = len(v)
+    m = [row[:] + [v[i]] for i, row in enumerate(a)]
+    for c in range(n):
+        p = max(range(c, n), key=lambda r: abs(m[r][c]))
+        m[c], m[p] = m[p], m[c]
+        for r in range(c + 1, n):
+            f = m[r][c] / m[c][c]
+            for k in range(c, n + 1):
+                m[r][k] -= f * m[c][k]
+    x = [0.0] * n
+    for r in reversed(range(n)):
+        x[r] = (m[r][n] - sum(m[r][k] * x[k] for k in range(r + 1, n))) / m[r][r]
+    return x
+
+def fit_ridge(xs, ys, l2=1e-2):
+    zs, mean, std = standardize(xs)
+    rows = [[1.0] + z for z in zs]
+    n = len(rows[0])
+    a = [[sum(r[i] * r[j] for r in rows) + (l2 if i == j and i > 0 else 0.0)
+          for j in range(n)] for i in range(n)]
+    v = [sum(r[i] * y for r, y in zip(rows, ys)) for i in range(n)]
+    x = solve(a, v)
+    return unstandardize(x[0], x[1:], mean, std)
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: %s <dump folder> <weights file>" % sys.argv[0])
+    folder, out = sys.argv[1], sys.argv[2]
+
+    features = {}
+    for row in read_rows(os.path.join(folder, "SIMDCostFeatures.csv")):
+        if len(row) != 2 + NUM_FEATURES:
+            sys.exit("unexpected feature record: %s" % ",".join(row))
+        features[(row[0], row[1])] = [float(v) for v in row[2:]]
+
+    samples = {}
+    for row in read_rows(os.path.join(folder, "SIMDCostOutcomes.csv")):
+        key = (row[0], row[1])
+        if key not in features:
+            continue
+        simd, spilled, cycles = int(row[2]), int(row[3]), float(row[5])
+        # compiles that aborted on spill have no cycle estimate
+        throughput = simd / cycles if cycles > 0 else None
+        samples.setdefault(simd, []).append((features[key], spilled, throughput))
+
+    with open(out, "w") as f:
+        f.write("# <simd> <spill|throughput> <bias> <weights...>, fitted from %s\n" % folder)
+        for simd in sorted(samples):
+            xs = [s[0] for s in samples[simd]]
+            spills = [s[1] for s in samples[simd]]
+            if len(xs) < 2:
+                continue
+            fits = [("spill", fit_logistic(xs, spills))]
+            timed = [s for s in samples[simd] if s[2] is not None]
+            if len(timed) >= 2:
+                fits.append(("throughput", fit_ridge([s[0] for s in timed], [s[2] for s in timed])))
+            for target, (bias, w) in fits:
+                f.write("%d %s %s\n" % (simd, target, " ".join("%.6g" % v for v in [bias] + w)))
+
+if __name__ == "__main__":
+    main()
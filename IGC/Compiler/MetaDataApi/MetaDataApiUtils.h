@@ -34,8 +34,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Metadata.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/TrackingMDRef.h>
 #include "common/LLVMWarningsPop.hpp"
 #include <vector>
+#include <map>
 
 namespace IGC
 {
@@ -484,6 +486,7 @@ public:
     {
         lazyLoad();
         m_data.clear();
+        m_savedNodes.clear();
         m_isDirty = true;
     }
 
@@ -501,7 +504,7 @@ public:
 
     iterator begin()
     {
-        lazyLoad();
+        loadAllItems();
         return m_data.begin();
     }
 
@@ -512,7 +515,7 @@ public:
 
     const_iterator begin() const
     {
-        lazyLoad();
+        loadAllItems();
         return m_data.begin();
     }
 
@@ -523,7 +526,6 @@ public:
 
     item_type getItem(const key_type& key) const
     {
-        lazyLoad();
         if (find(key) == end())
         {
             std::string Msg = "Invalid user defined function being processed: ";
@@ -537,7 +539,6 @@ public:
 
     item_type getOrInsertItem(const key_type& key)
     {
-        lazyLoad();
         if(find(key) == end())
         {
             m_data[key] = ValTraits::load(NULL);
@@ -561,25 +562,28 @@ public:
 
     item_type& operator[]( const key_type& key )
     {
-        lazyLoad();
+        find(key);
         return &m_data[key];
     }
 
     const item_type& operator[]( const key_type& key ) const
     {
-        lazyLoad();
+        find(key);
         return &m_data[key];
     }
 
     iterator find(const key_type& key) const
     {
         lazyLoad();
-        return m_data.find(key);
+        iterator it = m_data.find(key);
+        loadItem(it);
+        return it;
     }
 
     void erase(iterator where)
     {
         lazyLoad();
+        m_savedNodes.erase((*where).first);
         m_data.erase(where);
         m_isDirty = true;
     }
@@ -593,19 +597,21 @@ public:
 
         pNode->dropAllReferences();
 
-        meta_iterator mi(pNode,0);
-        meta_iterator me(pNode);
-        const_iterator i = begin();
-        const_iterator e = end();
-
-        while( i != e || mi != me )
+        // Only entries that changed since they were loaded or last saved are
+        // regenerated; the others keep the value node they already have.
+        for (const_iterator i = m_data.begin(), e = m_data.end(); i != e; ++i)
         {
-            assert( i != e && mi == me );
+            llvm::Metadata* pValue = getSavedNode(*i);
+            if (!pValue)
+            {
+                pValue = ValTraits::generateValue(context, (*i).second);
+                m_savedNodes[(*i).first] = SavedNode((*i).second, pValue);
+            }
+
             llvm::SmallVector<llvm::Metadata*, 2> args;
             args.push_back(KeyTraits::generateValue(context, (*i).first));
-            args.push_back(ValTraits::generateValue(context, (*i).second));
+            args.push_back(pValue);
             pNode->addOperand(llvm::MDNode::get(context,args));
-            ++i;
         }
     }
 
@@ -623,7 +629,8 @@ public:
 
         for( const_iterator i = m_data.begin(), e = m_data.end(); i != e; ++i )
         {
-            if( KeyTraits::dirty((*i).first) || ValTraits::dirty((*i).second) )
+            if( isItemLoaded(*i) &&
+                ( KeyTraits::dirty((*i).first) || ValTraits::dirty((*i).second) ) )
                 return true;
         }
         return false;
@@ -643,6 +650,8 @@ public:
 
         for( iterator i = m_data.begin(), e = m_data.end(); i != e; ++i )
         {
+            if( !isItemLoaded(*i) )
+                continue;
             KeyTraits::discardChanges((key_type&)((*i).first));
             ValTraits::discardChanges((item_type&)((*i).second));
         }
@@ -650,7 +659,33 @@ public:
         m_isDirty = false;
     }
 private:
+    // The value node an entry was loaded from or last saved to, together with
+    // the item it describes. An entry whose item is still null has not been
+    // deserialized yet.
+    typedef std::pair<item_type, llvm::TrackingMDRef> SavedNode;
+
+    static bool isItemLoaded(const std::pair<key_type, item_type>& entry)
+    {
+        return entry.second.get() != NULL;
+    }
+
+    // Returns the saved value node if the entry is unchanged since it was
+    // produced, NULL if the entry has to be regenerated.
+    llvm::Metadata* getSavedNode(const std::pair<key_type, item_type>& entry) const
+    {
+        typename std::map<key_type, SavedNode>::const_iterator saved = m_savedNodes.find(entry.first);
+        if (saved == m_savedNodes.end() || saved->second.first.get() != entry.second.get())
+        {
+            return NULL;
+        }
+        if (isItemLoaded(entry) && ValTraits::dirty(entry.second))
+        {
+            return NULL;
+        }
+        return saved->second.second.get();
+    }
 
+    // Only the keys are read up front; items are deserialized on first access.
     void lazyLoad() const
     {
         if( m_isLoaded || NULL == m_pNode )
@@ -663,16 +698,38 @@ private:
             llvm::MDNode *node = i.get();
             assert(node->getNumOperands() == 2 && "MetaDataMap node assumed to have exactly two operands");
             key_type key = KeyTraits::load(node->getOperand(0));
-            item_type val = ValTraits::load(node->getOperand(1));
-            m_data[key] = val;
+            m_data[key] = item_type();
+            m_savedNodes[key] = SavedNode(item_type(), llvm::TrackingMDRef(node->getOperand(1)));
         }
 
         m_isLoaded = true;
     }
 
+    void loadItem(iterator it) const
+    {
+        if (it == m_data.end() || isItemLoaded(*it))
+        {
+            return;
+        }
+
+        SavedNode& saved = m_savedNodes[(*it).first];
+        (*it).second = ValTraits::load(saved.second.get());
+        saved.first = (*it).second;
+    }
+
+    void loadAllItems() const
+    {
+        lazyLoad();
+        for (iterator i = m_data.begin(), e = m_data.end(); i != e; ++i)
+        {
+            loadItem(i);
+        }
+    }
+
 private:
     const llvm::NamedMDNode* m_pNode;
     mutable MapImplType m_data;
+    mutable std::map<key_type, SavedNode> m_savedNodes;
     bool m_isDirty;
     mutable bool m_isLoaded;
 };
@@ -40,6 +40,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 
 #include <unordered_map>
+#include <algorithm>
 
 using namespace llvm;
 using namespace IGC;
@@ -57,12 +58,29 @@ IGC_INITIALIZE_PASS_END(BIImport, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PA
 
 char BIImport::ID = 0;
 
-BIImport::BIImport(std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule) :
+BIImport::BIImport(
+    std::unique_ptr<Module> pGenericModule,
+    std::unique_ptr<Module> pSizeModule,
+    std::unique_ptr<MemoryBuffer> pCallGraph) :
     ModulePass(ID),
     m_GenericModule(std::move(pGenericModule)),
-    m_SizeModule(std::move(pSizeModule))
+    m_SizeModule(std::move(pSizeModule)),
+    m_CallGraph(std::move(pCallGraph))
 {
     initializeBIImportPass(*PassRegistry::getPassRegistry());
+
+    if (m_CallGraph && IGC_IS_FLAG_DISABLED(DisableBiFCallGraphIndex))
+    {
+        // Only split the index into lines here; entries are parsed on lookup.
+        // The index may have been embedded with CRLF line endings.
+        SmallVector<StringRef, 0> lines;
+        m_CallGraph->getBuffer().split(lines, '\n', -1, false);
+        m_CallGraphLines.reserve(lines.size());
+        for (StringRef line : lines)
+        {
+            m_CallGraphLines.push_back(line.rtrim("\r"));
+        }
+    }
 }
 
 
@@ -189,6 +207,23 @@ Function *BIImport::GetBuiltinFunction(llvm::StringRef funcName) const
     return nullptr;
 }
 
+bool BIImport::GetIndexedCallees(StringRef funcName, SmallVectorImpl<StringRef>& callees) const
+{
+    auto getCaller = [](StringRef line) { return line.substr(0, line.find(' ')); };
+
+    auto it = std::lower_bound(m_CallGraphLines.begin(), m_CallGraphLines.end(), funcName,
+        [&](StringRef line, StringRef name) { return getCaller(line) < name; });
+    if (it == m_CallGraphLines.end() || getCaller(*it) != funcName)
+    {
+        return false;
+    }
+
+    SmallVector<StringRef, 8> fields;
+    it->split(fields, ' ', -1, false);
+    callees.append(fields.begin() + 1, fields.end());
+    return true;
+}
+
 static bool materialized_use_empty(const Value *v)
 {
     return v->materialized_use_begin() == v->use_end();
@@ -290,6 +325,20 @@ bool BIImport::runOnModule(Module &M)
         }
     }
 
+    auto Materialize = [](Function *pFunc) -> bool
+    {
+        if (Error Err = pFunc->materialize()) {
+            std::string Msg;
+            handleAllErrors(std::move(Err), [&](ErrorInfoBase &EIB) {
+                errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
+            });
+            assert(0 && "Failed to materialize Global Variables");
+            return false;
+        }
+        pFunc->addAttribute(AttributeSet::FunctionIndex, llvm::Attribute::Builtin);
+        return true;
+    };
+
     std::function<void(Function*)> Explore = [&](Function *pRoot) -> void
     {
         TFunctionsVec calledFuncs;
@@ -310,26 +359,53 @@ bool BIImport::runOnModule(Module &M)
                 pFunc = pCallee;
             }
 
-            if (pFunc->isMaterializable())
+            if (pFunc->isMaterializable() && Materialize(pFunc))
             {
-                if (Error Err = pFunc->materialize()) {
-                    std::string Msg;
-                    handleAllErrors(std::move(Err), [&](ErrorInfoBase &EIB) {
-                        errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
-                    });
-                    assert(0 && "Failed to materialize Global Variables");
-                }
-                else {
-                    pFunc->addAttribute(AttributeSet::FunctionIndex, llvm::Attribute::Builtin);
-                    Explore(pFunc);
-                }
+                Explore(pFunc);
             }
         }
     };
 
-    for (auto &func : M)
+    if (!m_CallGraphLines.empty())
+    {
+        // The index already holds the callees of every builtin, so the transitive
+        // closure of the kernel's external calls is materialized by name without
+        // scanning builtin bodies. Builtins missing from the index (index built
+        // from a different module) fall back to scanning the materialized body.
+        SmallVector<StringRef, 64> worklist;
+        for (auto &F : M)
+        {
+            if (F.isDeclaration() && !F.use_empty())
+            {
+                worklist.push_back(F.getName());
+            }
+        }
+
+        while (!worklist.empty())
+        {
+            Function *pFunc = GetBuiltinFunction(worklist.pop_back_val());
+            if (!pFunc || !pFunc->isMaterializable() || !Materialize(pFunc))
+            {
+                continue;
+            }
+
+            if (!GetIndexedCallees(pFunc->getName(), worklist))
+            {
+                TFunctionsVec calledFuncs;
+                GetCalledFunctions(pFunc, calledFuncs);
+                for (auto *pCallee : calledFuncs)
+                {
+                    worklist.push_back(pCallee->getName());
+                }
+            }
+        }
+    }
+    else
     {
-        Explore(&func);
+        for (auto &func : M)
+        {
+            Explore(&func);
+        }
     }
 
     // nuke the unused functions so we can materializeAll() quickly
@@ -574,9 +650,10 @@ void BIImport::InitializeBIFlags(Module &M)
 }
 
 extern "C" llvm::ModulePass *createBuiltInImportPass(
-    std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule)
+    std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule,
+    std::unique_ptr<MemoryBuffer> pCallGraph)
 {
-    return new BIImport(std::move(pGenericModule), std::move(pSizeModule));
+    return new BIImport(std::move(pGenericModule), std::move(pSizeModule), std::move(pCallGraph));
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
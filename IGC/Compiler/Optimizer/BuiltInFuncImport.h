@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include <vector>
@@ -51,7 +52,8 @@ namespace IGC
 
         /// @brief Constructor
         BIImport(std::unique_ptr<llvm::Module> pGenericModule = nullptr,
-            std::unique_ptr<llvm::Module> pSizeModule = nullptr);
+            std::unique_ptr<llvm::Module> pSizeModule = nullptr,
+            std::unique_ptr<llvm::MemoryBuffer> pCallGraph = nullptr);
 
         /// @brief analyses used
         virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
@@ -89,16 +91,28 @@ namespace IGC
         /// @param  funcName - name of func to search for.
         llvm::Function *GetBuiltinFunction(llvm::StringRef funcName) const;
 
+        /// @brief  Look up the callees of a builtin in the call-graph index.
+        /// @param  funcName - name of the builtin.
+        /// @param  [OUT] callees - names of the functions it calls are appended here.
+        /// @return false if the index has no entry for funcName.
+        bool GetIndexedCallees(llvm::StringRef funcName, llvm::SmallVectorImpl<llvm::StringRef>& callees) const;
+
     protected:
         /// Builtin module - contains the source function definition to import
         std::unique_ptr<llvm::Module> m_GenericModule;
         std::unique_ptr<llvm::Module> m_SizeModule;
+
+        /// Build-time call-graph index of the builtin modules (see BiFModule/bif_callgraph.py).
+        /// Each line is "<caller> <callee>*"; lines are sorted by caller.
+        std::unique_ptr<llvm::MemoryBuffer> m_CallGraph;
+        std::vector<llvm::StringRef> m_CallGraphLines;
     };
 
 } // namespace IGC
 
 extern "C" llvm::ModulePass *createBuiltInImportPass(
-    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule);
+    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule,
+    std::unique_ptr<llvm::MemoryBuffer> pCallGraph);
 
 namespace IGC
 {
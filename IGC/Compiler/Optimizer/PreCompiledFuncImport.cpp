@@ -162,6 +162,30 @@ const LibraryModuleInfo PreCompiledFuncImport::m_libModInfos[NUM_LIBMODS] =
 	/* LIBMOD_SP_DIV      */   { igcbuiltin_emu_sp_div, sizeof(igcbuiltin_emu_sp_div) }
 };
 
+// Returns the library module defining the emulation function with the given
+// name, or -1 if it is not an emulation function.
+int PreCompiledFuncImport::getLibModID(StringRef funcName)
+{
+    for (int i = 0; i < NUM_FUNCTION_IDS; ++i)
+    {
+        if (funcName == m_functionInfos[i].FuncName)
+        {
+            return m_functionInfos[i].LibModID;
+        }
+    }
+    for (int i = 0; i < NUM_FUNCTIONS; ++i)
+    {
+        for (int j = 0; j < NUM_TYPES; ++j)
+        {
+            if (funcName == m_sFunctionNames[i][j])
+            {
+                return LIBMOD_INT_DIV_REM;
+            }
+        }
+    }
+    return -1;
+}
+
 // This function scans intructions before emulation. It converts double-related
 // operations (intrinsics, instructions) into ones that can be emulated. It has:
 //   1. Intrinsics
@@ -369,25 +393,33 @@ bool PreCompiledFuncImport::runOnModule(Module &M)
  
     visit(M);
 
-    if (m_changed)
+    // Library modules are linked only for the functions that are needed,
+    // so an emulation function calling into another library module leaves a
+    // new declaration behind. Keep linking until no such declaration is left,
+    // requesting each declaration at most once so that a library missing a
+    // definition cannot make this loop forever.
+    SmallPtrSet<Function*, 16> requestedDecls;
+    bool linkedLibModule = m_changed;
+    while (linkedLibModule)
     {
+        linkedLibModule = false;
         llvm::Linker ld(M);
         for (int i=0; i < NUM_LIBMODS; ++i)
         {
             if (!m_libModuleToBeImported[i]) {
                 continue;
             }
+            m_libModuleToBeImported[i] = false;
+            linkedLibModule = true;
 
             const char* pLibraryModule = (const char*)m_libModInfos[i].Mod;
             uint32_t libSize = m_libModInfos[i].ModSize;
 
-            // Load the module we want to compile and link it to existing module
-            //StringRef BitRef((char*)preCompiledFunctionLibrary, preCompiledFunctionLibrarySize);
+            // Load the library lazily, straight from the static array. Only
+            // the function bodies the linker pulls in below get materialized.
             StringRef BitRef(pLibraryModule, libSize);
-            //llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-            //    llvm::getLazyBitcodeModule(MemoryBufferRef(BitRef.str(), ""), M.getContext());
             llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                llvm::parseBitcodeFile(MemoryBufferRef(BitRef.str(), ""), M.getContext());
+                llvm::getLazyBitcodeModule(MemoryBufferRef(BitRef, ""), M.getContext());
             assert(ModuleOrErr && "llvm getLazyBitcodeModule - FAILED to parse bitcode");
             std::unique_ptr<llvm::Module> m_pBuiltinModule = std::move(*ModuleOrErr);
             assert(m_pBuiltinModule && "llvm version mismatch - could not load llvm module");
@@ -397,16 +429,28 @@ bool PreCompiledFuncImport::runOnModule(Module &M)
             m_pBuiltinModule->setDataLayout(M.getDataLayout());
             m_pBuiltinModule->setTargetTriple(M.getTargetTriple());
 
-            // Linking the two modules
-            llvm::Linker ld(M);
-
-            if (ld.linkInModule(std::move(m_pBuiltinModule)))
+            // Link only the emulation functions this module declares, plus
+            // whatever they call, instead of the whole library.
+            if (ld.linkInModule(std::move(m_pBuiltinModule), llvm::Linker::LinkOnlyNeeded))
             {
                 assert(0 && "Error linking the two modules");
             }
 
             m_pBuiltinModule = nullptr;
         }
+
+        for (auto &F : M)
+        {
+            if (F.isDeclaration() && !F.use_empty() &&
+                requestedDecls.insert(&F).second)
+            {
+                int libModID = getLibModID(F.getName());
+                if (libModID >= 0)
+                {
+                    m_libModuleToBeImported[libModID] = true;
+                }
+            }
+        }
     }
 
 	bool hasNewMDEntry = false;
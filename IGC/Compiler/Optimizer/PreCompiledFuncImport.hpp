@@ -202,6 +202,7 @@ namespace IGC
 		bool isDPConvFunc(llvm::Function *F) const;
 
         bool m_libModuleToBeImported[NUM_LIBMODS];
+        static int getLibModID(llvm::StringRef funcName);
 
         static const PreCompiledFuncInfo m_functionInfos[NUM_FUNCTION_IDS];
         static const LibraryModuleInfo m_libModInfos[NUM_LIBMODS];
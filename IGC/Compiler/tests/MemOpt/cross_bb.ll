@@ -0,0 +1,130 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: env IGC_EnableMemOptCrossBB=1 igc_opt %s -S -o - -basicaa -igc-memopt | FileCheck %s
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f80:128:128-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-a:64:64-f80:128:128-n8:16:32:64"
+
+; 'entry' and 'join' are control-equivalent. The store in the side branch
+; does not alias '%src', so the load in 'join' is merged into the leading
+; load in 'entry'.
+
+define void @f0(i32 addrspace(1)* noalias %dst, i32 addrspace(1)* noalias %src, i1 %c) {
+entry:
+  %0 = load i32, i32 addrspace(1)* %src, align 4
+  br i1 %c, label %then, label %else
+
+then:
+  store i32 %0, i32 addrspace(1)* %dst, align 4
+  br label %join
+
+else:
+  br label %join
+
+join:
+  %arrayidx1 = getelementptr inbounds i32, i32 addrspace(1)* %src, i32 1
+  %1 = load i32, i32 addrspace(1)* %arrayidx1, align 4
+  %arrayidx2 = getelementptr inbounds i32, i32 addrspace(1)* %dst, i32 1
+  store i32 %1, i32 addrspace(1)* %arrayidx2, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @f0
+; CHECK: entry:
+; CHECK: [[VEC:%[0-9]+]] = load <2 x i32>, <2 x i32> addrspace(1)*
+; CHECK-DAG: [[E0:%[0-9]+]] = extractelement <2 x i32> [[VEC]], i32 0
+; CHECK-DAG: [[E1:%[0-9]+]] = extractelement <2 x i32> [[VEC]], i32 1
+; CHECK: then:
+; CHECK: store i32 [[E0]], i32 addrspace(1)* %dst, align 4
+; CHECK: join:
+; CHECK-NOT: load
+; CHECK: store i32 [[E1]], i32 addrspace(1)* %arrayidx2, align 4
+; CHECK: ret void
+
+
+; The side branch writes the element loaded in 'join'. Moving that load up to
+; 'entry' would read the old value, so the loads stay separate.
+
+define void @f1(i32 addrspace(1)* %dst, i32 addrspace(1)* %src, i1 %c) {
+entry:
+  %0 = load i32, i32 addrspace(1)* %src, align 4
+  br i1 %c, label %then, label %join
+
+then:
+  %arrayidx0 = getelementptr inbounds i32, i32 addrspace(1)* %src, i32 1
+  store i32 %0, i32 addrspace(1)* %arrayidx0, align 4
+  br label %join
+
+join:
+  %arrayidx1 = getelementptr inbounds i32, i32 addrspace(1)* %src, i32 1
+  %1 = load i32, i32 addrspace(1)* %arrayidx1, align 4
+  store i32 %1, i32 addrspace(1)* %dst, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @f1
+; CHECK: entry:
+; CHECK-NOT: load <2 x i32>
+; CHECK: load i32, i32 addrspace(1)* %src, align 4
+; CHECK: then:
+; CHECK: join:
+; CHECK: load i32, i32 addrspace(1)* %arrayidx1, align 4
+; CHECK: ret void
+
+
+; 'then' is not control-equivalent to 'entry': merging its load into 'entry'
+; would perform it on paths that did not, so the loads stay separate.
+
+define void @f2(i32 addrspace(1)* noalias %dst, i32 addrspace(1)* noalias %src, i1 %c) {
+entry:
+  %0 = load i32, i32 addrspace(1)* %src, align 4
+  store i32 %0, i32 addrspace(1)* %dst, align 4
+  br i1 %c, label %then, label %join
+
+then:
+  %arrayidx1 = getelementptr inbounds i32, i32 addrspace(1)* %src, i32 1
+  %1 = load i32, i32 addrspace(1)* %arrayidx1, align 4
+  %arrayidx2 = getelementptr inbounds i32, i32 addrspace(1)* %dst, i32 1
+  store i32 %1, i32 addrspace(1)* %arrayidx2, align 4
+  br label %join
+
+join:
+  ret void
+}
+
+; CHECK-LABEL: define void @f2
+; CHECK: entry:
+; CHECK-NOT: load <2 x i32>
+; CHECK: load i32, i32 addrspace(1)* %src, align 4
+; CHECK: then:
+; CHECK: load i32, i32 addrspace(1)* %arrayidx1, align 4
+; CHECK: ret void
+
+!igc.functions = !{!0, !3, !4}
+!0 = !{void (i32 addrspace(1)*, i32 addrspace(1)*, i1)* @f0, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{void (i32 addrspace(1)*, i32 addrspace(1)*, i1)* @f1, !1}
+!4 = !{void (i32 addrspace(1)*, i32 addrspace(1)*, i1)* @f2, !1}
@@ -0,0 +1,62 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: igc_opt -igc-image-func-analysis -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; Only @foo gains an implicit argument. Its metadata is regenerated with the
+; new argument and keeps its other fields; @bar's metadata is left as is.
+
+declare i32 @__builtin_IB_get_image_width(i32 %img)
+
+define i32 @foo(i32 %img) nounwind {
+  %w = call i32 @__builtin_IB_get_image_width(i32 %img)
+  ret i32 %w
+}
+
+define i32 @bar(i32 %x) nounwind {
+  ret i32 %x
+}
+
+!igc.functions = !{!0, !4}
+!0 = !{i32 (i32)* @foo, !1}
+!1 = !{!2, !3}
+!2 = !{!"function_type", i32 0}
+!3 = !{!"thread_group_size", i32 1, i32 2, i32 3}
+!4 = !{i32 (i32)* @bar, !5}
+!5 = !{!2, !6}
+!6 = !{!"thread_group_size", i32 4, i32 5, i32 6}
+
+; CHECK: !igc.functions = !{![[F0:[0-9]+]], ![[F1:[0-9]+]]}
+; CHECK-DAG: ![[F0]] = !{i32 (i32)* @foo, ![[I0:[0-9]+]]}
+; CHECK-DAG: ![[I0]] = !{![[T:[0-9]+]], ![[A0:[0-9]+]], ![[G0:[0-9]+]]}
+; CHECK-DAG: ![[T]] = !{!"function_type", i32 0}
+; CHECK-DAG: ![[A0]] = !{!"implicit_arg_desc", ![[W:[0-9]+]]}
+; CHECK-DAG: ![[W]] = !{i32 19, ![[N:[0-9]+]]}
+; CHECK-DAG: ![[N]] = !{!"explicit_arg_num", i32 0}
+; CHECK-DAG: ![[G0]] = !{!"thread_group_size", i32 1, i32 2, i32 3}
+; CHECK-DAG: ![[F1]] = !{i32 (i32)* @bar, ![[I1:[0-9]+]]}
+; CHECK-DAG: ![[I1]] = !{![[T]], ![[G1:[0-9]+]]}
+; CHECK-DAG: ![[G1]] = !{!"thread_group_size", i32 4, i32 5, i32 6}
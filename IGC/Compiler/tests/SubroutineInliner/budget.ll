@@ -0,0 +1,117 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: env IGC_SubroutineInlinerBudget=32 igc_opt %s -S -o - -SubroutineInliner | FileCheck %s --check-prefix=BUDGET
+; RUN: env IGC_SubroutineInlinerBudget=1 igc_opt %s -S -o - -SubroutineInliner | FileCheck %s --check-prefix=SMALL
+; RUN: env IGC_SubroutineInlinerBudget=1000 igc_opt %s -S -o - -SubroutineInliner | FileCheck %s --check-prefix=LARGE
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f80:128:128-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-a:64:64-f80:128:128-n8:16:32:64"
+
+; Sizes are instruction counts. @k starts at 26: itself (12), @tiny (2),
+; @big (6) and @mid (6). Calls to @tiny (trivial) and @mid (called once)
+; cost 0; the three calls to @big cost 6 each. A budget of 32 takes one
+; of them: the one in the loop, which runs 8 times as often as the others.
+; The call to @big that @mid brings into @k was not in the plan and stays
+; a call.
+
+; BUDGET-LABEL: define void @k(
+; BUDGET-NOT: call i32 @tiny
+; BUDGET: %s = call i32 @big(
+; BUDGET-NOT: call i32 @mid
+; BUDGET: call i32 @big(i32 %s)
+; BUDGET-NOT: call
+; BUDGET: ret void
+
+; A kernel over the budget still gets the free calls.
+
+; SMALL-LABEL: define void @k(
+; SMALL-NOT: call i32 @tiny
+; SMALL: %s = call i32 @big(
+; SMALL-NOT: call i32 @mid
+; SMALL: call i32 @big(i32 %s)
+; SMALL: loop:
+; SMALL: call i32 @big(i32 %acc)
+; SMALL: ret void
+
+; With room for everything, the call in @mid is inlined before @mid is, so
+; nothing is left to clone.
+
+; LARGE-LABEL: define void @k(
+; LARGE-NOT: call
+; LARGE: ret void
+
+define i32 @tiny(i32 %x) {
+entry:
+  %r = add i32 %x, 1
+  ret i32 %r
+}
+
+define i32 @big(i32 %x) {
+entry:
+  %c = icmp sgt i32 %x, 0
+  br i1 %c, label %pos, label %done
+
+pos:
+  %y = mul i32 %x, 3
+  br label %done
+
+done:
+  %r = phi i32 [ %x, %entry ], [ %y, %pos ]
+  ret i32 %r
+}
+
+define i32 @mid(i32 %x) {
+entry:
+  %c = icmp eq i32 %x, 0
+  br i1 %c, label %zero, label %done
+
+zero:
+  %v = call i32 @big(i32 %x)
+  br label %done
+
+done:
+  %r = phi i32 [ %x, %entry ], [ %v, %zero ]
+  ret i32 %r
+}
+
+define void @k(i32 addrspace(1)* %p, i32 %n) {
+entry:
+  %t = call i32 @tiny(i32 %n)
+  %s = call i32 @big(i32 %t)
+  %m = call i32 @mid(i32 %s)
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i1, %loop ]
+  %acc = phi i32 [ %m, %entry ], [ %v, %loop ]
+  %v = call i32 @big(i32 %acc)
+  %i1 = add i32 %i, 1
+  %c = icmp slt i32 %i1, %n
+  br i1 %c, label %loop, label %exit
+
+exit:
+  store i32 %v, i32 addrspace(1)* %p, align 4
+  ret void
+}
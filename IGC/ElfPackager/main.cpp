@@ -84,7 +84,9 @@ void MakeHeader(StringRef Func, SmallVector<char, 0> &headerVector, int index)
 	headerVector.push_back((char)(index >> 8));
 }
 
-void CreateElfSection(CLElfLib::CElfWriter* pWriter, CLElfLib::SSectionNode sectionNode, std::string Name, char* pData, unsigned DataSize)
+// With byReference the writer doesn't copy pData, which must then stay alive
+// until the binary is written.
+void CreateElfSection(CLElfLib::CElfWriter* pWriter, CLElfLib::SSectionNode sectionNode, std::string Name, char* pData, unsigned DataSize, bool byReference = false)
 {
 	// Create section
 	sectionNode.Name = Name;
@@ -94,7 +96,10 @@ void CreateElfSection(CLElfLib::CElfWriter* pWriter, CLElfLib::SSectionNode sect
 	sectionNode.Type = SH_TYPE_PROG_BITS;
 
 	// Add it to the file
-	pWriter->AddSection(&sectionNode);
+	if (byReference)
+		pWriter->AddSectionReference(&sectionNode);
+	else
+		pWriter->AddSection(&sectionNode);
 }
 
 
@@ -459,32 +464,22 @@ int main(int argc, char *argv[])
 			OS_sizet64.str().size());
 	}
 	
-	//Now to add all of the sections in the file
-	for (auto elf_iterator : ElfMap) 
+	//Now to add all of the sections in the file, ElfMap outlives the write
+	//so its buffers are referenced rather than copied
+	for (const auto& elf_iterator : ElfMap) 
 	{
 		CreateElfSection(pWriter,
 			sectionNode,
 			elf_iterator.first,
 			const_cast<char*>(elf_iterator.second.data()),
-			elf_iterator.second.size());
+			elf_iterator.second.size(),
+			true);
 	}
 
-	// Resolve size of ELF blob
+	// Write ELF file to disk, sections are streamed without building the blob in memory
 	size_t dataSize = 0;
-	char* ElfBlob = NULL;
-	pWriter->ResolveBinary(ElfBlob, dataSize);
-	ElfBlob = new char[dataSize];
-	if (ElfBlob == NULL)
-	{
-		return -1;
-	}
-	pWriter->ResolveBinary(ElfBlob, dataSize);
-
-	// Write ELF file to disk
 	std::ofstream ofs(OutputPath, std::ifstream::binary);
-	ofs.write(ElfBlob, dataSize);
-	delete[] ElfBlob;
-	if (!ofs.good())
+	if (pWriter->WriteBinary(ofs, dataSize) != CLElfLib::SUCCESS)
 	{
 		return -1;
 	}
@@ -77,8 +77,10 @@ void DumpLLVMIR(IGC::CodeGenContext* pContext, const char* dumpName)
 	SetCurrentDebugHash(pContext->hash.asmHash.value);
     if (IGC_IS_FLAG_ENABLED(DumpLLVMIR))
     {
+        COMPILER_TIME_START(pContext, TIME_MetaData);
         pContext->getMetaDataUtils()->save(toLLVMContext(*pContext));
         serialize(*(pContext->getModuleMetaData()), pContext->getModule());
+        COMPILER_TIME_END(pContext, TIME_MetaData);
         using namespace IGC::Debug;
         auto name =
             DumpName(IGC::Debug::GetShaderOutputName())
@@ -101,17 +103,17 @@ void DumpLLVMIR(IGC::CodeGenContext* pContext, const char* dumpName)
             .Extension("ll");
         SMDiagnostic Err;
         std::string fileName = name.overridePath();
-        FILE* fp = fopen(fileName.c_str(), "r");
-        if (fp != nullptr)
+        if (shaderOverrideFileExists(fileName))
         {
-            fclose(fp);
             errs() << "Override shader: " << fileName << "\n";
             Module* mod = parseIRFile(fileName, Err, toLLVMContext(*pContext)).release();
             if (mod)
             {
                 pContext->deleteModule();
                 pContext->setModule(mod);
+                COMPILER_TIME_START(pContext, TIME_MetaData);
                 deserialize(*(pContext->getModuleMetaData()), mod);
+                COMPILER_TIME_END(pContext, TIME_MetaData);
                 appendToShaderOverrideLogFile(fileName, "OVERRIDEN: ");
             }
             else
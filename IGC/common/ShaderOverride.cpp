@@ -31,6 +31,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "visaBuilder_interface.h"
 #include "common/secure_mem.h"
 #include "common/secure_string.h"
+#include "common/shaderOverride.hpp"
+#include <chrono>
+#include <unordered_set>
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include "common/LLVMWarningsPop.hpp"
 #if defined(WIN32)
 #include "WinDef.h"
 #include "Windows.h"
@@ -75,37 +84,87 @@ static void * GetProcAddress(
 
 
 
+namespace {
+/// Names of the files in the shader override directory. The directory is
+/// scanned once per process, so checking a compiled shader for an override
+/// is a hash lookup instead of a file system probe per candidate name.
+/// Files added to the directory after the first lookup are not seen.
+class ShaderOverrideIndex
+{
+public:
+    static const ShaderOverrideIndex& get()
+    {
+        static const ShaderOverrideIndex index;
+        return index;
+    }
+
+    bool contains(const std::string& path) const
+    {
+        if(!m_valid ||
+            path.compare(0, m_folder.size(), m_folder) != 0)
+        {
+            return llvm::sys::fs::exists(path);
+        }
+        return m_files.count(path.substr(m_folder.size())) != 0;
+    }
+
+private:
+    ShaderOverrideIndex() :
+        m_folder(IGC::Debug::GetShaderOverridePath()),
+        m_valid(false)
+    {
+        std::error_code ec;
+        llvm::sys::fs::directory_iterator it(m_folder, ec), end;
+        for(; !ec && it != end; it.increment(ec))
+        {
+            m_files.insert(llvm::sys::path::filename(it->path()).str());
+        }
+        // a missing directory just means there is nothing to override
+        m_valid = !ec || ec == std::errc::no_such_file_or_directory;
+    }
+
+    std::string m_folder;
+    std::unordered_set<std::string> m_files;
+    bool m_valid;
+};
+
+std::string overrideMessage(
+    const char* message,
+    std::chrono::steady_clock::time_point start)
+{
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return std::string(message) + " (" + std::to_string(usec) + " us): ";
+}
+}
+
+bool shaderOverrideFileExists(const std::string& fileName)
+{
+    return ShaderOverrideIndex::get().contains(fileName);
+}
+
 static void* loadBinFile(
     const std::string& fileName,
     int& binSize)
 {
-    FILE* fp;
-    fp = fopen(fileName.c_str(), "rb");
-    if(fp == nullptr)
+    // the file is mapped rather than read through stdio when it is large
+    // enough; the copy is needed because the caller owns a malloc'ed block
+    auto bufOrErr = llvm::MemoryBuffer::getFile(fileName, -1, false);
+    if(!bufOrErr)
     {
         return nullptr;
     }
 
-    fseek(fp, 0, SEEK_END);
-    binSize = int_cast<int>(ftell(fp));
-    rewind(fp);
+    const llvm::MemoryBuffer& file = **bufOrErr;
+    binSize = int_cast<int>(file.getBufferSize());
 
     void* buf = malloc(sizeof(char)* binSize);
     if(buf == nullptr)
     {
-        fclose(fp);
-        return nullptr;
-    }
-
-    size_t nr = fread(buf, 1, binSize, fp);
-    if(nr != binSize)
-    {
-        fclose(fp);
-        free(buf);
         return nullptr;
     }
 
-    fclose(fp);
+    memcpy_s(buf, binSize, file.getBufferStart(), binSize);
     return buf;
 }
 
@@ -155,21 +214,23 @@ void appendToShaderOverrideLogFile(std::string &binFileName, const char * messag
 
 void overrideShaderIGA(const IGC::CodeGenContext* context, void *& genxbin, int & binSize, std::string &binFileName, bool &binOverride)
 {
-    std::ifstream is(binFileName.c_str(), std::ios::in);
-    std::string asmContext;
     void * overrideBinary = nullptr;
     uint32_t overrideBinarySize = 0;
 
-    if(is.is_open())
+    if(!shaderOverrideFileExists(binFileName))
     {
-        asmContext.append(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
-        is.close();
+        binOverride = false;
+        return;
     }
-    else
+
+    auto start = std::chrono::steady_clock::now();
+    auto asmOrErr = llvm::MemoryBuffer::getFile(binFileName);
+    if(!asmOrErr)
     {
         binOverride = false;
         return;
     }
+    std::unique_ptr<llvm::MemoryBuffer> asmContext = std::move(*asmOrErr);
 
     HMODULE hModule = NULL;
     pIGACreateContext           fCreateContext;
@@ -238,7 +299,7 @@ void overrideShaderIGA(const IGC::CodeGenContext* context, void *& genxbin, int
 
     iga_assemble_options_t asmOpts = IGA_ASSEMBLE_OPTIONS_INIT();
 
-    if(fIGAAssemble(ctx, &asmOpts, asmContext.c_str(), &overrideBinary, &overrideBinarySize) != IGA_SUCCESS) {
+    if(fIGAAssemble(ctx, &asmOpts, asmContext->getBufferStart(), &overrideBinary, &overrideBinarySize) != IGA_SUCCESS) {
         binOverride = false;
 		appendToShaderOverrideLogFile(binFileName, "OVERRIDE FAILED DUE TO SHADER ASSEMBLY FAILURE: ");
         return;
@@ -254,7 +315,7 @@ void overrideShaderIGA(const IGC::CodeGenContext* context, void *& genxbin, int
         binSize = overrideBinarySize;
         binOverride = true;
 
-        appendToShaderOverrideLogFile(binFileName, "OVERRIDEN: ");
+        appendToShaderOverrideLogFile(binFileName, overrideMessage("OVERRIDEN", start).c_str());
     }
 
     fIGAReleaseContext(ctx);
@@ -266,6 +327,12 @@ void overrideShaderBinary(void *& genxbin, int & binSize, std::string &binFileNa
     void* loadBin = nullptr;
     int loadBinSize = 0;
 
+    if(!shaderOverrideFileExists(binFileName))
+    {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
     loadBin = loadBinFile(binFileName, loadBinSize);
     if(loadBin != nullptr)
     {
@@ -273,6 +340,6 @@ void overrideShaderBinary(void *& genxbin, int & binSize, std::string &binFileNa
         genxbin = loadBin;
         binSize = loadBinSize;
         binOverride = true;
-        appendToShaderOverrideLogFile(binFileName, "OVERRIDEN: ");
+        appendToShaderOverrideLogFile(binFileName, overrideMessage("OVERRIDEN", start).c_str());
     }
 }
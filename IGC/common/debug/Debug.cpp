@@ -49,6 +49,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // Windows.h defines MemoryFence as _mm_mfence, but this conflicts with llvm::sys::MemoryFence
 #undef MemoryFence
 #endif
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <exception>
@@ -326,6 +327,18 @@ void DumpUnlock()
     stream_mutex.unlock();
 }
 
+void AppendToDumpFile(const char* fileName, const std::string& text)
+{
+    std::string path = std::string(GetShaderOutputFolder()) + fileName;
+    DumpLock();
+    std::ofstream os(path, std::ios::app);
+    if (os.is_open())
+    {
+        os << text;
+    }
+    DumpUnlock();
+}
+
 } // namespace Debug
 
 int getPointerSize(llvm::Module &M) {
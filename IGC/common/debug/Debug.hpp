@@ -68,6 +68,10 @@ namespace IGC
 
         extern void DumpLock();
         extern void DumpUnlock();
+
+        /// Append text to fileName in the shader dump folder, serialized
+        /// with the other dumps.
+        void AppendToDumpFile(const char* fileName, const std::string& text);
     }
 
     int getPointerSize(llvm::Module &M);
@@ -27,6 +27,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <string>
 #include "Compiler/CodeGenPublic.h"
 
+/// Looks fileName up in an index of the override directory built on first use.
+bool shaderOverrideFileExists(const std::string& fileName);
 void appendToShaderOverrideLogFile(std::string &binFileName, const char * message);
 void overrideShaderBinary(void *& genxbin, int & binSize, std::string &binFileName, bool &binOverride);
 void overrideShaderIGA(const IGC::CodeGenContext* context, void *& genxbin, int & binSize, std::string &binFileName, bool &binOverride);
@@ -29,6 +29,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <sstream>
 #include <fstream>
 #include <list>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include "visa_igc_common_header.h"
 #include "Common_ISA.h"
@@ -729,6 +733,72 @@ void CISA_IR_Builder::emitFCPatchFile()
 
 // default size of the kernel mem manager in bytes
 #define KERNEL_MEM_SIZE    (4*1024*1024)
+// Optimize and register allocate the given compilation units on a pool of
+// at most maxThreads threads, the calling thread included. Units do not share
+// IR or memory managers at this point, and the stitching that follows still
+// walks them in their original order, so the final layout does not depend on
+// which thread finished first.
+// Returns the status of the first failing unit in that order.
+static int compileUnitsInParallel(
+    CISA_IR_Builder* builder,
+    const std::vector<VISAKernelImpl*>& units,
+    unsigned maxThreads)
+{
+    std::vector<int> unitStatus(units.size(), CM_SUCCESS);
+    std::atomic<unsigned> nextUnit(0);
+
+    auto worker = [&]()
+    {
+        for (unsigned i = nextUnit++; i < units.size(); i = nextUnit++)
+        {
+            unitStatus[i] = units[i]->compileFastPathOptimize();
+        }
+    };
+
+    unsigned numThreads = std::max(1u, std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, std::max(1u, maxThreads));
+    numThreads = std::min(numThreads, (unsigned)units.size());
+
+    // The current builder, platform, stepping and timers are thread local, so
+    // each worker starts from the calling thread's builder state and hands its
+    // timers back when it is done.
+    TARGET_PLATFORM platform = getGenxPlatform();
+    Stepping stepping = GetStepping();
+    std::vector<TimerSnapshot> workerTimers(numThreads);
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < numThreads; i++)
+    {
+        threads.emplace_back([&, i]()
+        {
+            pCisaBuilder = builder;
+            SetVisaPlatform(platform);
+            SetVisaStepping(stepping);
+            initTimer();
+            worker();
+            saveTimers(workerTimers[i]);
+        });
+    }
+    worker();
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    for (unsigned i = 1; i < numThreads; i++)
+    {
+        addTimers(workerTimers[i]);
+    }
+
+    for (int status : unitStatus)
+    {
+        if (status != CM_SUCCESS)
+        {
+            return status;
+        }
+    }
+    return CM_SUCCESS;
+}
+
 int CISA_IR_Builder::Compile( const char* nameInput)
 {
 
@@ -811,6 +881,10 @@ int CISA_IR_Builder::Compile( const char* nameInput)
 
         pseudoHeader.functions = (function_info_t*)mem.alloc(sizeof(function_info_t) * pseudoHeader.num_functions);
 
+        bool compileInParallel = m_options.getOption(vISA_ParallelCompileUnits) &&
+            m_kernels.size() > 1;
+        std::vector<VISAKernelImpl*> parallelUnits;
+
         int i;
         unsigned int k = 0;
         std::list<G4_Kernel*> compilationUnits;
@@ -848,12 +922,43 @@ int CISA_IR_Builder::Compile( const char* nameInput)
 
             m_currentKernel = kernel;
 
-            int status =  kernel->compileFastPath();
+            int status = compileInParallel ?
+                kernel->compileFastPathBuildCFG() : kernel->compileFastPath();
 			if (status != CM_SUCCESS)
 			{
                 stopTimer(TIMER_TOTAL);
 				return status;
             }
+            if (compileInParallel)
+            {
+                parallelUnits.push_back(kernel);
+            }
+        }
+
+        if (compileInParallel)
+        {
+            // RA turns off local RA for the rest of the compile once it sees a
+            // unit with subroutines. Decide that up front so the shared options
+            // are not written while the units are being compiled.
+            if (m_options.getTarget() == VISA_3D)
+            {
+                for (auto unit : parallelUnits)
+                {
+                    if (unit->getKernel()->fg.funcInfoTable.size() > 0)
+                    {
+                        m_options.setOption(vISA_LocalRA, false);
+                        break;
+                    }
+                }
+            }
+
+            int status = compileUnitsInParallel(this, parallelUnits,
+                m_options.getuInt32Option(vISA_ParallelCompileThreads));
+            if (status != CM_SUCCESS)
+            {
+                stopTimer(TIMER_TOTAL);
+                return status;
+            }
         }
 
         savedFCallStates savedFCallState;
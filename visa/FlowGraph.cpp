@@ -3741,31 +3741,36 @@ void G4_Kernel::dumpPassInternal(const char* appendix)
     else
         ofile << asmFileName << std::endl << std::endl;
 
+    emitG4IR(ofile);
+
+    ofile.close();
+}
+
+void G4_Kernel::emitG4IR(std::ostream& output)
+{
     for (std::list<G4_BB*>::iterator it = fg.BBs.begin();
         it != fg.BBs.end(); ++it)
     {
         // Emit BB number
         G4_BB* bb = (*it);
-        bb->writeBBId(ofile);
-        ofile << "\tPreds: ";
+        bb->writeBBId(output);
+        output << "\tPreds: ";
         for (auto pred : bb->Preds)
         {
-            pred->writeBBId(ofile);
-            ofile << " ";
+            pred->writeBBId(output);
+            output << " ";
         }
-        ofile << "\tSuccs: ";
+        output << "\tSuccs: ";
         for (auto succ : bb->Succs)
         {
-            succ->writeBBId(ofile);
-            ofile << " ";
+            succ->writeBBId(output);
+            output << " ";
         }
-        ofile << "\n";
+        output << "\n";
 
-        bb->emit(ofile);
-        ofile << "\n\n";
+        bb->emit(output);
+        output << "\n\n";
     } // bbs
-
-    ofile.close();
 }
 
 //
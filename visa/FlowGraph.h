@@ -999,6 +999,7 @@ private:
 	DO(LOCAL_FIRST_FIT_RA) \
 	DO(HYBRID_BC_RA) \
 	DO(HYBRID_RA) \
+	DO(HYBRID_LINEAR_SCAN_RA) \
 	DO(GRAPH_COLORING_RR_BC_RA) \
 	DO(GRAPH_COLORING_FF_BC_RA) \
 	DO(GRAPH_COLORING_RR_RA) \
@@ -1224,6 +1225,8 @@ public:
     
     void evalAddrExp(void);
     void dumpDotFile(const char* appendix);
+    /// Emit the basic blocks of this kernel with their preds/succs.
+    void emitG4IR(std::ostream& output);
 
     void setVersion( unsigned char major_ver, unsigned char minor_ver )
     {
@@ -91,6 +91,9 @@ unsigned int BitMask[BITS_DWORD] =
 const char* GraphColor::StackCallStr = "StackCall";
 
 static const unsigned IN_LOOP_REFERENCE_COUNT_FACTOR = 4;
+// Hybrid RA uses linear scan for global ranges when max pressure
+// times this factor is below the number of GRFs.
+static const unsigned LINEAR_SCAN_RA_PRESSURE_FACTOR = 2;
 
 #define BANK_CONFLICT_HEURISTIC_INST   0.05
 #define BANK_CONFLICT_HEURISTIC_REF_COUNT  0.25
@@ -5241,6 +5244,21 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
                     lrs[i]->getDegree() : 1.0f*lrs[i]->getRefCount()*lrs[i]->getRefCount() / (lrs[i]->getDegree() + 1);
             }
 
+            // Prefer spilling ranges that remat can recompute at
+            // their uses instead of inserting spill/fill code.
+            if (cheapRematRanges &&
+                (*cheapRematRanges)[i])
+            {
+                spillCost *= REMATSPILLCOSTRATIO;
+            }
+
+            // In-loop segments of ranges split around loops
+            // are colored before the rest.
+            if (gra.isLoopSplitDcl(dcl))
+            {
+                spillCost *= LOOPSPLITSPILLCOSTRATIO;
+            }
+
             lrs[i]->setSpillCost(spillCost);
 
             // Track address sensitive live range.
@@ -9006,6 +9024,350 @@ void VarSplit::globalSplit(IR_Builder& builder, G4_Kernel &kernel)
     return;
 }
 
+bool VarSplit::canDoLoopSplit(IR_Builder& builder, G4_Kernel &kernel)
+{
+    // Loop info is only computed for 3D, and copies inserted at
+    // loop boundaries aren't handled by stack call save/restore.
+    return builder.getOption(vISA_LoopVarSplit) &&
+        !builder.getOption(vISA_Debug) &&
+        kernel.getOptions()->getTarget() == VISA_3D &&
+        !kernel.fg.naturalLoops.empty() &&
+        !kernel.fg.getHasStackCalls() &&
+        !kernel.fg.getIsStackCallFunc();
+}
+
+unsigned int VarSplit::getNumSpillRefsInLoops(G4_Kernel& kernel, const LIVERANGE_LIST& spilledLRs)
+{
+    // Each reference to a spilled range turns into a fill or a spill
+    // when spill code is inserted.
+    std::unordered_set<G4_Declare*> spilledDcls;
+    for (auto lr : spilledLRs)
+    {
+        spilledDcls.insert(lr->getDcl()->getRootDeclare());
+    }
+
+    unsigned int numRefs = 0;
+    for (auto bb : kernel.fg.BBs)
+    {
+        if (bb->getNestLevel() == 0)
+        {
+            continue;
+        }
+
+        for (auto inst : bb->instList)
+        {
+            if (inst->isPseudoKill() || inst->isLifeTimeEnd())
+            {
+                continue;
+            }
+
+            auto dst = inst->getDst();
+            if (dst && dst->getTopDcl() &&
+                spilledDcls.find(dst->getTopDcl()->getRootDeclare()) != spilledDcls.end())
+            {
+                numRefs++;
+            }
+
+            for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+            {
+                auto src = inst->getSrc(i);
+                if (src && src->isSrcRegRegion() && src->getTopDcl() &&
+                    spilledDcls.find(src->getTopDcl()->getRootDeclare()) != spilledDcls.end())
+                {
+                    numRefs++;
+                }
+            }
+        }
+    }
+
+    return numRefs;
+}
+
+void VarSplit::insertLoopSplitMoves(IR_Builder& builder, G4_Declare* dstDcl, G4_Declare* srcDcl, INST_LIST &instList, INST_LIST_ITER instIter)
+{
+    // Copy whole variable with NoMask movs of at most 2 GRFs each
+    unsigned int numRows = srcDcl->getNumRows();
+    unsigned int dwordsPerGRF = G4_GRF_REG_NBYTES / G4_Type_Table[Type_UD].byteSize;
+    for (unsigned int row = 0; row < numRows; row += 2)
+    {
+        unsigned int rowsToCopy = std::min(2u, numRows - row);
+        G4_DstRegRegion* dst = builder.createDstRegRegion(Direct, dstDcl->getRegVar(), (short)row, 0, 1, Type_UD);
+        G4_SrcRegRegion* src = builder.createSrcRegRegion(Mod_src_undef, Direct, srcDcl->getRegVar(), (short)row, 0,
+            builder.getRegionStride1(), Type_UD);
+        G4_INST* movInst = builder.createInternalInst(nullptr, G4_mov, nullptr, false,
+            (unsigned char)(rowsToCopy * dwordsPerGRF), dst, src, nullptr, InstOpt_WriteEnable);
+        instList.insert(instIter, movInst);
+    }
+}
+
+bool VarSplit::splitAroundLoop(IR_Builder& builder, G4_Declare* dcl, const FlowGraph::Blocks& loopBody, G4_BB* header,
+    G4_BB* preheader, const std::set<G4_BB*>& exitBBs, LivenessAnalysis& liveAnalysis)
+{
+    unsigned int id = dcl->getRegVar()->getId();
+    bool liveIn = liveAnalysis.isLiveAtEntry(header, id);
+    bool liveOut = false;
+    for (auto exitBB : exitBBs)
+    {
+        liveOut |= liveAnalysis.isLiveAtEntry(exitBB, id);
+    }
+
+    if (!liveIn && !liveOut)
+    {
+        // Range is contained in the loop, nothing to split
+        return false;
+    }
+
+    bool hasDef = false;
+    bool hasRef = false;
+    for (auto bb : loopBody)
+    {
+        for (auto inst : bb->instList)
+        {
+            auto dst = inst->getDst();
+            if (dst && dst->getTopDcl() &&
+                dst->getTopDcl()->getRootDeclare() == dcl)
+            {
+                if (dst->getTopDcl() != dcl ||
+                    dst->getRegAccess() != Direct)
+                {
+                    return false;
+                }
+                hasDef = true;
+                hasRef = true;
+            }
+
+            for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+            {
+                auto src = inst->getSrc(i);
+                if (src && src->isSrcRegRegion() && src->getTopDcl() &&
+                    src->getTopDcl()->getRootDeclare() == dcl)
+                {
+                    if (src->getTopDcl() != dcl ||
+                        src->asSrcRegRegion()->getRegAccess() != Direct ||
+                        inst->isLifeTimeEnd())
+                    {
+                        return false;
+                    }
+                    hasRef = true;
+                }
+            }
+        }
+    }
+
+    if (!hasRef)
+    {
+        return false;
+    }
+
+    const char* name = builder.getNameString(builder.mem, 32, "%s_loop%d", dcl->getName(), header->getId());
+    G4_Declare* loopDcl = builder.createDeclareNoLookup(name, G4_GRF, dcl->getNumElems(), dcl->getNumRows(), dcl->getElemType());
+    loopDcl->setAlign(dcl->getAlign());
+    loopDcl->setSubRegAlign(dcl->getSubRegAlign());
+    gra.setLoopSplitDcl(loopDcl);
+
+    for (auto bb : loopBody)
+    {
+        for (auto inst : bb->instList)
+        {
+            auto dst = inst->getDst();
+            if (dst && dst->getTopDcl() == dcl)
+            {
+                G4_DstRegRegion* newDst = builder.createDstRegRegion(Direct, loopDcl->getRegVar(),
+                    dst->getRegOff(), dst->getSubRegOff(), dst->getHorzStride(), dst->getType());
+                inst->setDest(newDst);
+            }
+
+            for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+            {
+                auto src = inst->getSrc(i);
+                if (src && src->isSrcRegRegion() && src->getTopDcl() == dcl)
+                {
+                    G4_SrcRegRegion* oldSrc = src->asSrcRegRegion();
+                    G4_SrcRegRegion* newSrc = builder.createSrcRegRegion(oldSrc->getModifier(), Direct,
+                        loopDcl->getRegVar(), oldSrc->getRegOff(), oldSrc->getSubRegOff(),
+                        oldSrc->getRegion(), oldSrc->getType());
+                    inst->setSrc(newSrc, i);
+                }
+            }
+        }
+    }
+
+    if (liveIn)
+    {
+        auto insertIt = preheader->instList.end();
+        if (!preheader->instList.empty() &&
+            preheader->instList.back()->isFlowControl())
+        {
+            insertIt--;
+        }
+        insertLoopSplitMoves(builder, loopDcl, dcl, preheader->instList, insertIt);
+    }
+
+    if (liveOut && hasDef)
+    {
+        for (auto exitBB : exitBBs)
+        {
+            if (!liveAnalysis.isLiveAtEntry(exitBB, id))
+            {
+                continue;
+            }
+
+            auto insertIt = exitBB->instList.begin();
+            while (insertIt != exitBB->instList.end() &&
+                ((*insertIt)->isLabel() || (*insertIt)->opcode() == G4_join))
+            {
+                insertIt++;
+            }
+            insertLoopSplitMoves(builder, dcl, loopDcl, exitBB->instList, insertIt);
+        }
+    }
+
+    return true;
+}
+
+unsigned int VarSplit::loopSplit(IR_Builder& builder, G4_Kernel &kernel, LivenessAnalysis& liveAnalysis, const LIVERANGE_LIST& spilledLRs)
+{
+    // Split spilled ranges that cross loop boundaries so that the in-loop
+    // segment is allocated separately with higher priority. When the outer
+    // segment is spilled, its spill/fill code is only at loop boundaries.
+    std::vector<G4_Declare*> candidates;
+    for (auto lr : spilledLRs)
+    {
+        G4_Declare* dcl = lr->getDcl();
+        if (dcl->getAliasDeclare() ||
+            dcl->getRegFile() != G4_GRF ||
+            dcl->getAddressed() ||
+            dcl->isInput() ||
+            dcl->isOutput() ||
+            dcl->getHasFileScope() ||
+            dcl->getIsPartialDcl() ||
+            dcl->getIsSplittedDcl() ||
+            dcl->isDoNotSpill() ||
+            kernel.fg.isPseudoDcl(dcl) ||
+            gra.isLoopSplitDcl(dcl) ||
+            dcl->getByteSize() % G4_GRF_REG_NBYTES != 0)
+        {
+            continue;
+        }
+        candidates.push_back(dcl);
+    }
+
+    if (candidates.empty())
+    {
+        return 0;
+    }
+
+    // Visit inner loops first as they are the hottest.
+    std::vector<std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>> loops;
+    for (auto& loop : kernel.fg.naturalLoops)
+    {
+        loops.push_back(std::make_pair(loop.first, &loop.second));
+    }
+    std::stable_sort(loops.begin(), loops.end(),
+        [](const std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>& l1,
+            const std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>& l2)
+    {
+        return l1.second->size() < l2.second->size();
+    });
+
+    // A range is split at most once per BB so that nested loops
+    // don't rename references that were already renamed.
+    std::map<G4_Declare*, std::set<G4_BB*>> splitBBs;
+    unsigned int numSplits = 0;
+    for (auto& loop : loops)
+    {
+        auto header = loop.first.second;
+        auto& loopBody = *loop.second;
+
+        G4_BB* preheader = nullptr;
+        unsigned int numOutsidePreds = 0;
+        for (auto pred : header->Preds)
+        {
+            if (loopBody.find(pred) == loopBody.end())
+            {
+                preheader = pred;
+                numOutsidePreds++;
+            }
+        }
+
+        if (numOutsidePreds != 1 ||
+            preheader->Succs.size() != 1 ||
+            preheader->getBBType() != G4_BB_NONE_TYPE)
+        {
+            continue;
+        }
+
+        bool isCandidateLoop = true;
+        std::set<G4_BB*> exitBBs;
+        for (auto bb : loopBody)
+        {
+            if (bb->getBBType() & (G4_BB_CALL_TYPE | G4_BB_RETURN_TYPE) ||
+                bb->isEndWithFCall())
+            {
+                isCandidateLoop = false;
+                break;
+            }
+
+            for (auto succ : bb->Succs)
+            {
+                if (loopBody.find(succ) == loopBody.end())
+                {
+                    exitBBs.insert(succ);
+                }
+            }
+        }
+
+        // Copies at exits must only execute when leaving the loop
+        for (auto exitBB : exitBBs)
+        {
+            if (exitBB->getBBType() != G4_BB_NONE_TYPE)
+            {
+                isCandidateLoop = false;
+            }
+
+            for (auto pred : exitBB->Preds)
+            {
+                if (loopBody.find(pred) == loopBody.end())
+                {
+                    isCandidateLoop = false;
+                }
+            }
+        }
+
+        if (!isCandidateLoop)
+        {
+            continue;
+        }
+
+        for (auto dcl : candidates)
+        {
+            auto& visitedBBs = splitBBs[dcl];
+            bool overlaps = false;
+            for (auto bb : loopBody)
+            {
+                if (visitedBBs.find(bb) != visitedBBs.end())
+                {
+                    overlaps = true;
+                    break;
+                }
+            }
+
+            if (overlaps)
+            {
+                continue;
+            }
+
+            if (splitAroundLoop(builder, dcl, loopBody, header, preheader, exitBBs, liveAnalysis))
+            {
+                visitedBBs.insert(loopBody.begin(), loopBody.end());
+                numSplits++;
+            }
+        }
+    }
+
+    return numSplits;
+}
+
 void VarSplit::localSplit(IR_Builder& builder,
     G4_BB* bb)
 {
@@ -9551,6 +9913,21 @@ bool GlobalRA::hybridRA(bool doBankConflictReduction, bool highInternalConflict,
             return false;
         }
 
+        if (builder.getOption(vISA_GlobalLinearScanRA) &&
+            rpe.getMaxRP() * LINEAR_SCAN_RA_PRESSURE_FACTOR < kernel.getNumRegTotal())
+        {
+            if (builder.getOption(vISA_RATrace))
+            {
+                std::cout << "\t--global linear scan RA, pressure: " << rpe.getMaxRP() << "\n";
+            }
+            GlobalLinearScan linearScan(*this, liveAnalysis, kernel.getNumRegTotal(), doBankConflictReduction);
+            if (linearScan.run())
+            {
+                kernel.setRAType(RA_Type::HYBRID_LINEAR_SCAN_RA);
+                return true;
+            }
+        }
+
         GraphColor coloring(liveAnalysis, kernel.getNumRegTotal(), true, false);
 
         unsigned spillRegSize = 0;
@@ -9750,9 +10127,39 @@ int GlobalRA::coloringRegAlloc()
             rpe.run();
             GraphColor coloring(liveAnalysis, kernel.getNumRegTotal(), false, forceSpill);
 
+            bool runRemat = kernel.getOptions()->getTarget() == VISA_CM ? true :
+                kernel.getSimdSize() < 32;
+            // -noremat takes precedence over -forceremat
+            bool rematOff = !kernel.getOption(vISA_Debug) &&
+                (!kernel.getOption(vISA_NoRemat) || kernel.getOption(vISA_FastSpill)) &&
+                (kernel.getOption(vISA_ForceRemat) || runRemat);
+
+            // If coloring fails remat runs before spill code is inserted,
+            // so ranges it can recompute are made cheap to spill.
+            std::vector<bool> cheapRematRanges;
+            if (!rematDone &&
+                rematOff &&
+                !isReRAPass() &&
+                kernel.getOption(vISA_RematSpillCost))
+            {
+                Rematerialization::getCheapRematRanges(kernel, liveAnalysis, cheapRematRanges);
+                coloring.setCheapRematRanges(&cheapRematRanges);
+            }
+
             unsigned spillRegSize = 0;
             unsigned indrSpillRegSize = 0;
             bool isColoringGood = coloring.regAlloc(doBankConflictReduction, highInternalConflict, reserveSpillReg, spillRegSize, indrSpillRegSize, &rpe);
+
+            if (splitPass.reportLoopSplit)
+            {
+                if (builder.getOption(vISA_RATrace))
+                {
+                    std::cout << "\t--spill refs in loops before/after loop split: " << splitPass.loopSpillRefsBefore << "/" <<
+                        (isColoringGood ? 0 : VarSplit::getNumSpillRefsInLoops(kernel, coloring.getSpilledLiveRanges())) << "\n";
+                }
+                splitPass.reportLoopSplit = false;
+            }
+
             if (isColoringGood == false)
             {
                 if (isReRAPass())
@@ -9761,12 +10168,6 @@ int GlobalRA::coloringRegAlloc()
                     return CM_SPILL;
                 }
 
-                bool runRemat = kernel.getOptions()->getTarget() == VISA_CM ? true : 
-                    kernel.getSimdSize() < 32;
-                // -noremat takes precedence over -forceremat
-                bool rematOff = !kernel.getOption(vISA_Debug) &&
-                    (!kernel.getOption(vISA_NoRemat) || kernel.getOption(vISA_FastSpill)) &&
-                    (kernel.getOption(vISA_ForceRemat) || runRemat);
                 bool rematChange = false;
                 bool globalSplitChange = false;
 
@@ -9818,8 +10219,32 @@ int GlobalRA::coloringRegAlloc()
                     globalSplitChange = true;
                 }
 
+                // Liveness is stale once remat or global split changed the IR,
+                // so loop split waits for the next coloring attempt.
+                bool loopSplitChange = false;
+                if (iterationNo == 0 &&
+                    !rematChange &&
+                    !globalSplitChange &&
+                    !splitPass.didLoopSplit &&
+                    splitPass.canDoLoopSplit(builder, kernel))
+                {
+                    unsigned int spillRefsInLoops = VarSplit::getNumSpillRefsInLoops(kernel, coloring.getSpilledLiveRanges());
+                    unsigned int numSplits = splitPass.loopSplit(builder, kernel, liveAnalysis, coloring.getSpilledLiveRanges());
+                    if (builder.getOption(vISA_RATrace))
+                    {
+                        std::cout << "\t--loop split: " << numSplits << " ranges\n";
+                    }
+                    splitPass.didLoopSplit = true;
+                    if (numSplits > 0)
+                    {
+                        splitPass.loopSpillRefsBefore = spillRefsInLoops;
+                        splitPass.reportLoopSplit = true;
+                        loopSplitChange = true;
+                    }
+                }
+
                 if (iterationNo == 0 &&
-                    (rematChange || globalSplitChange))
+                    (rematChange || globalSplitChange || loopSplitChange))
                 {
                     continue;
                 }
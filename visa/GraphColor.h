@@ -45,6 +45,10 @@ namespace vISA
 {
     const float MAXSPILLCOST = (std::numeric_limits<float>::max());
     const float MINSPILLCOST = -(std::numeric_limits<float>::max());
+    // Spill cost of ranges that remat can recompute is scaled down by this ratio
+    const float REMATSPILLCOSTRATIO = 0.01f;
+    // Spill cost of in-loop segments created by loop split is scaled up by this ratio
+    const float LOOPSPLITSPILLCOSTRATIO = 4.0f;
 
     class BankConflictPass
     {
@@ -553,6 +557,10 @@ namespace vISA
         LIVERANGE_LIST constrainedWorklist;
         unsigned int numColor = 0;
 
+        // Ranges that rematerialization can cheaply recompute, indexed by var id.
+        // Set only when remat will run if coloring fails.
+        const std::vector<bool>* cheapRematRanges = nullptr;
+
 #define GRAPH_COLOR_MEM_SIZE 16*1024
 
         // This function returns the weight of interference edge lr1--lr2,
@@ -725,6 +733,7 @@ namespace vISA
         static const char* StackCallStr;
 
         const Options * getOptions() { return m_options; }
+        void setCheapRematRanges(const std::vector<bool>* ranges) { cheapRematRanges = ranges; }
 
         bool regAlloc(
             bool doBankConflictReduction,
@@ -787,6 +796,7 @@ namespace vISA
         AugmentationMasks maskType = AugmentationMasks::Undetermined;
         std::vector<G4_Declare*> subDclList;
         unsigned int subOff = 0;
+        bool isLoopSplitDcl = false;
     };
 
     class GlobalRA
@@ -1077,6 +1087,23 @@ namespace vISA
             vars[dclid].subOff = offset;
         }
 
+        bool isLoopSplitDcl(G4_Declare* dcl) const
+        {
+            auto dclid = dcl->getDeclId();
+            if (dclid >= vars.size())
+            {
+                return defaultValues.isLoopSplitDcl;
+            }
+            return vars[dclid].isLoopSplitDcl;
+        }
+
+        void setLoopSplitDcl(G4_Declare* dcl)
+        {
+            auto dclid = dcl->getDeclId();
+            resize(dclid);
+            vars[dclid].isLoopSplitDcl = true;
+        }
+
         G4_Align getBankAlign(G4_Declare*);
         bool areAllDefsNoMask(G4_Declare*);
         void removeUnreferencedDcls();
@@ -1136,14 +1163,25 @@ namespace vISA
         void createSubDcls(G4_Kernel& kernel, G4_Declare* oldDcl, std::vector<G4_Declare*> &splitDclList);
         void insertMovesToTemp(IR_Builder& builder, G4_Declare* oldDcl, G4_Operand *dstOpnd, INST_LIST &instList, INST_LIST_ITER instIter, std::vector<G4_Declare*> &splitDclList);
         void insertMovesFromTemp(G4_Kernel& kernel, G4_Declare* oldDcl, int index, G4_Operand *srcOpnd, int pos, INST_LIST &instList, INST_LIST_ITER instIter, std::vector<G4_Declare*> &splitDclList);
+        void insertLoopSplitMoves(IR_Builder& builder, G4_Declare* dstDcl, G4_Declare* srcDcl, INST_LIST &instList, INST_LIST_ITER instIter);
+        bool splitAroundLoop(IR_Builder& builder, G4_Declare* dcl, const FlowGraph::Blocks& loopBody, G4_BB* header,
+            G4_BB* preheader, const std::set<G4_BB*>& exitBBs, LivenessAnalysis& liveAnalysis);
 
     public:
         bool didLocalSplit = false;
         bool didGlobalSplit = false;
+        bool didLoopSplit = false;
+        // Number of spill/fill references inside loops before loop split, reported
+        // once RA has run on the split program.
+        unsigned int loopSpillRefsBefore = 0;
+        bool reportLoopSplit = false;
 
         void localSplit(IR_Builder& builder, G4_BB* bb);
         void globalSplit(IR_Builder& builder, G4_Kernel &kernel);
         bool canDoGlobalSplit(IR_Builder& builder, G4_Kernel &kernel, uint32_t instNum, uint32_t spillRefCount, uint32_t sendSpillRefCount);
+        bool canDoLoopSplit(IR_Builder& builder, G4_Kernel &kernel);
+        unsigned int loopSplit(IR_Builder& builder, G4_Kernel &kernel, LivenessAnalysis& liveAnalysis, const LIVERANGE_LIST& spilledLRs);
+        static unsigned int getNumSpillRefsInLoops(G4_Kernel& kernel, const LIVERANGE_LIST& spilledLRs);
 
         VarSplit(GlobalRA& g) : kernel(g.kernel), gra(g)
         {
@@ -3132,6 +3132,365 @@ void LinearScan::freeAllocedRegs(LocalLiveRange* lr, bool setInstID)
         idx);
 }
 
+// ********* GlobalLinearScan class implementation *********
+
+GlobalLinearScan::GlobalLinearScan(GlobalRA& g, LivenessAnalysis& l, unsigned int nregs, bool bankConflict) :
+    gra(g), kernel(g.kernel), builder(g.builder), liveAnalysis(l), numRegs(nregs), doBankConflict(bankConflict)
+{
+
+}
+
+// Compute a single interval per range that covers all its references and
+// all BB boundaries where it is live. The interval is the hull of the live
+// points so it is conservative for ranges with holes.
+bool GlobalLinearScan::computeIntervals(std::vector<Interval>& candidates, std::vector<Interval>& fixed)
+{
+    unsigned int numVars = liveAnalysis.getNumSelectedVar();
+    std::vector<unsigned int> start(numVars, UINT_MAX);
+    std::vector<unsigned int> end(numVars, 0);
+    std::vector<bool> avoidR127(numVars, false);
+
+    auto extend = [&start, &end](unsigned int id, unsigned int idx)
+    {
+        start[id] = std::min(start[id], idx);
+        end[id] = std::max(end[id], idx);
+    };
+
+    bbStart.resize(kernel.fg.BBs.size());
+    bbEnd.resize(kernel.fg.BBs.size());
+
+    unsigned int idx = 0;
+    for (auto bb : kernel.fg.BBs)
+    {
+        unsigned int first = idx;
+        unsigned int last = bb->instList.empty() ? idx : idx + (unsigned int)bb->instList.size() - 1;
+        bbStart[bb->getId()] = first;
+        bbEnd[bb->getId()] = last;
+
+        for (unsigned int id = 0; id < numVars; id++)
+        {
+            if (liveAnalysis.isLiveAtEntry(bb, id))
+            {
+                extend(id, first);
+            }
+            if (liveAnalysis.isLiveAtExit(bb, id))
+            {
+                extend(id, last);
+            }
+        }
+
+        for (auto inst : bb->instList)
+        {
+            G4_DstRegRegion* dst = inst->getDst();
+            if (dst && dst->getBase()->isRegAllocPartaker())
+            {
+                unsigned int id = dst->getBase()->asRegVar()->getId();
+                extend(id, idx);
+
+                if (inst->isSend() && !inst->isSplitSend() && builder.needsToReserveR127())
+                {
+                    avoidR127[id] = true;
+                }
+            }
+
+            for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+            {
+                G4_Operand* src = inst->getSrc(i);
+                if (src == NULL)
+                {
+                    continue;
+                }
+
+                if (src->isAddrExp())
+                {
+                    return false;
+                }
+
+                if (src->isSrcRegRegion() && src->getBase()->isRegAllocPartaker())
+                {
+                    G4_RegVar* var = src->getBase()->asRegVar();
+                    extend(var->getId(), idx);
+
+                    if (inst->isEOT() &&
+                        builder.hasEOTGRFBinding() &&
+                        !var->isPhyRegAssigned())
+                    {
+                        // EOT sources need r112-r127
+                        return false;
+                    }
+                }
+            }
+
+            idx++;
+        }
+
+        if (bb->instList.empty())
+        {
+            idx++;
+        }
+    }
+
+    unsigned int lastIdx = idx;
+    for (unsigned int id = 0; id < numVars; id++)
+    {
+        G4_RegVar* var = liveAnalysis.vars[id];
+        G4_Declare* dcl = var->getDeclare();
+
+        Interval interval;
+        interval.dcl = dcl;
+        interval.start = start[id];
+        interval.end = end[id];
+        interval.regNum = 0;
+        interval.subRegNum = 0;
+        interval.avoidR127 = avoidR127[id];
+
+        if (var->isPhyRegAssigned())
+        {
+            if (!var->isGreg())
+            {
+                continue;
+            }
+
+            if (dcl->isOutput())
+            {
+                // Output ranges hold their register until the end
+                interval.start = 0;
+                interval.end = lastIdx;
+            }
+            else if (interval.start == UINT_MAX)
+            {
+                continue;
+            }
+
+            interval.regNum = var->getPhyReg()->asGreg()->getRegNum();
+            interval.subRegNum = (var->getPhyRegOff() * dcl->getElemSize()) / 2;
+            fixed.push_back(interval);
+            continue;
+        }
+
+        if (dcl->getRegFile() != G4_GRF ||
+            dcl->isOutput() ||
+            dcl->getIsPartialDcl() ||
+            dcl->getIsSplittedDcl() ||
+            liveAnalysis.isAddressSensitive(id))
+        {
+            return false;
+        }
+
+        candidates.push_back(interval);
+    }
+
+    return true;
+}
+
+void GlobalLinearScan::markBusy(PhyRegsLocalRA& regs, const Interval& interval)
+{
+    int regNum = interval.regNum;
+    int subRegNum = interval.subRegNum;
+    int numWords = interval.dcl->getWordSize();
+    while (numWords > 0 && regNum < (int)numRegs)
+    {
+        int wordsInGRF = std::min(numWords, NUM_WORDS_PER_GRF - subRegNum);
+        if (regs.isGRFAvailable(regNum))
+        {
+            if (wordsInGRF == NUM_WORDS_PER_GRF)
+            {
+                regs.setGRFBusy(regNum);
+            }
+            else
+            {
+                regs.setWordBusy(regNum, subRegNum, wordsInGRF);
+            }
+        }
+        numWords -= wordsInGRF;
+        subRegNum = 0;
+        regNum++;
+    }
+}
+
+void GlobalLinearScan::markLRABusy(PhyRegsLocalRA& regs, const Interval& interval)
+{
+    // Registers used by local RA in any BB the interval overlaps
+    for (auto bb : kernel.fg.BBs)
+    {
+        if (bbStart[bb->getId()] > interval.end ||
+            bbEnd[bb->getId()] < interval.start)
+        {
+            continue;
+        }
+
+        PhyRegSummary* summary = kernel.fg.getBBLRASummary(bb);
+        if (summary == NULL)
+        {
+            continue;
+        }
+
+        for (unsigned int i = 0; i < numRegs; i++)
+        {
+            if (summary->isGRFBusy(i) && regs.isGRFAvailable(i))
+            {
+                regs.setGRFBusy(i);
+            }
+        }
+    }
+}
+
+// Augmentation in graph coloring 2GRF aligns every multi-row GRF range of
+// a SIMD16+ 3D kernel unless all its defs are NoMask. Masks aren't known
+// yet when linear scan runs, so require even alignment for all of them.
+bool GlobalLinearScan::needsEvenAlign(G4_Declare* dcl) const
+{
+    if (!(kernel.getOptions()->getTarget() == VISA_3D &&
+        kernel.getSimdSize() >= 16 &&
+        kernel.fg.BBs.size() > 2))
+    {
+        return false;
+    }
+
+    G4_Declare* topdcl = dcl->getRootDeclare();
+    return !topdcl->getIsPartialDcl() &&
+        topdcl->getElemSize() >= 4 &&
+        topdcl->getNumRows() > 1 &&
+        !(builder.getOption(vISA_enablePreemption) &&
+            dcl == builder.getBuiltinR0());
+}
+
+bool GlobalLinearScan::assignRegs(PhyRegsLocalRA& regs, Interval& interval)
+{
+    G4_Declare* dcl = interval.dcl;
+    G4_Align align = dcl->getAlign();
+    bool evenAlign = align == Even || needsEvenAlign(dcl);
+    if (evenAlign)
+    {
+        align = Even;
+    }
+    if (doBankConflict &&
+        gra.getBankConflict(dcl) != BANK_CONFLICT_NONE)
+    {
+        G4_Align bankAlign = gra.getBankAlign(dcl);
+        // Bank alignment may only refine, never drop, even alignment
+        if (bankAlign != Either &&
+            (!evenAlign || bankAlign == Even || bankAlign == Even2GRF))
+        {
+            align = bankAlign;
+        }
+    }
+    G4_SubReg_Align subAlign = builder.GRFAlign() ? Sixteen_Word : dcl->getSubRegAlign();
+
+    if (interval.avoidR127 &&
+        numRegs > 127 &&
+        regs.isGRFAvailable(127))
+    {
+        regs.setGRFBusy(127);
+    }
+
+    PhyRegsManager pregManager(regs, false);
+    int nrows = pregManager.findFreeRegs(dcl->getWordSize(), align, subAlign,
+        interval.regNum, interval.subRegNum, 0, numRegs - 1, 0, false);
+
+    return nrows != 0;
+}
+
+bool GlobalLinearScan::run()
+{
+    if (kernel.fg.getHasStackCalls() ||
+        kernel.fg.getIsStackCallFunc() ||
+        !kernel.fg.funcInfoTable.empty() ||
+        kernel.getHasAddrTaken() ||
+        builder.getOption(vISA_GenerateDebugInfo))
+    {
+        return false;
+    }
+
+    std::vector<Interval> candidates;
+    std::vector<Interval> fixed;
+    if (!computeIntervals(candidates, fixed))
+    {
+        return false;
+    }
+
+    PhyRegsLocalRA initRegs(builder.getOptions()->getuInt32Option(vISA_TotalGRFNum));
+    vector<unsigned int> forbiddenRegs;
+    getForbiddenGRFs(forbiddenRegs, builder.getOptions(), 0, 0, builder.getOptions()->getuInt32Option(vISA_ReservedGRFNum));
+    for (auto regNum : forbiddenRegs)
+    {
+        initRegs.setGRFUnavailable(regNum);
+    }
+    for (unsigned int i = numRegs; i < builder.getOptions()->getuInt32Option(vISA_TotalGRFNum); i++)
+    {
+        initRegs.setGRFUnavailable(i);
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const Interval& i1, const Interval& i2) { return i1.start < i2.start; });
+
+    std::list<Interval*> active;
+    for (auto& interval : candidates)
+    {
+        PhyRegsLocalRA regs = initRegs;
+
+        if (interval.start == UINT_MAX)
+        {
+            // Never referenced or live, any register will do
+            if (!assignRegs(regs, interval))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        active.remove_if([&interval](Interval* a) { return a->end < interval.start; });
+        for (auto a : active)
+        {
+            markBusy(regs, *a);
+        }
+
+        for (auto& f : fixed)
+        {
+            if (f.start <= interval.end && f.end >= interval.start)
+            {
+                markBusy(regs, f);
+            }
+        }
+
+        markLRABusy(regs, interval);
+
+        if (!assignRegs(regs, interval))
+        {
+            if (builder.getOption(vISA_RATrace))
+            {
+                std::cout << "\t--global linear scan failed to assign " << interval.dcl->getName() << "\n";
+            }
+            return false;
+        }
+
+        active.push_back(&interval);
+    }
+
+    for (auto& interval : candidates)
+    {
+        G4_Declare* dcl = interval.dcl;
+        int subRegNum = interval.subRegNum;
+        // adjust subreg num to type size
+        if (dcl->getElemSize() == 1)
+        {
+            subRegNum *= 2;
+        }
+        else
+        {
+            subRegNum /= (dcl->getElemSize() / 2);
+        }
+        dcl->getRegVar()->setPhyReg(builder.phyregpool.getGreg(interval.regNum), subRegNum);
+    }
+
+    if (builder.getOption(vISA_RATrace))
+    {
+        std::cout << "\t--global linear scan assigned " << candidates.size() << " ranges\n";
+    }
+
+    return true;
+}
+
 // ********* PhyRegSummary class implementation *********
 
 // Mark GRFs as used
@@ -46,6 +46,7 @@ class PhyRegsManager;
 class PhyRegSummary;
 class BankConflictPass;
 class GlobalRA;
+class LivenessAnalysis;
 }
 
 vISA::G4_Declare* GetTopDclFromRegRegion(vISA::G4_Operand* opnd);
@@ -543,6 +544,46 @@ public:
 
 };
 
+// Linear scan over whole-kernel live intervals of ranges left unassigned by
+// local RA. Intervals are computed from liveness over the layout order of BBs,
+// so no interference graph is needed. Used by hybrid RA when register pressure
+// is low; returns false if some range can't be assigned so that graph
+// coloring can take over.
+class GlobalLinearScan
+{
+private:
+    struct Interval
+    {
+        G4_Declare* dcl;
+        unsigned int start;
+        unsigned int end;
+        int regNum;
+        int subRegNum;  // in words
+        bool avoidR127;
+    };
+
+    GlobalRA& gra;
+    G4_Kernel& kernel;
+    IR_Builder& builder;
+    LivenessAnalysis& liveAnalysis;
+    unsigned int numRegs;
+    bool doBankConflict;
+
+    std::vector<unsigned int> bbStart;
+    std::vector<unsigned int> bbEnd;
+
+    bool computeIntervals(std::vector<Interval>& candidates, std::vector<Interval>& fixed);
+    void markBusy(PhyRegsLocalRA& regs, const Interval& interval);
+    void markLRABusy(PhyRegsLocalRA& regs, const Interval& interval);
+    bool needsEvenAlign(G4_Declare* dcl) const;
+    bool assignRegs(PhyRegsLocalRA& regs, Interval& interval);
+
+public:
+    GlobalLinearScan(GlobalRA& g, LivenessAnalysis& l, unsigned int nregs, bool bankConflict);
+
+    bool run();
+};
+
 class PhyRegSummary
 {
 private:
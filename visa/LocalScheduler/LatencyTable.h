@@ -134,6 +134,10 @@ namespace vISA
 
             return Latency(latency, occupancy, occupancyMultiplier);
         }
+
+        Latency getSendLatency(CISA_SHARED_FUNCTION_ID sfid) const {
+            return SendLatTable.at(sfid);
+        }
     };
 }
 
@@ -3962,7 +3962,8 @@ int regAlloc(IR_Builder& builder, PhyRegPool& regPool, G4_Kernel& kernel)
 
     //FIXME: here is a temp WA
     if (kernel.fg.funcInfoTable.size() > 0 && 
-        kernel.fg.builder->getOptions()->getTarget() == VISA_3D)
+        kernel.fg.builder->getOptions()->getTarget() == VISA_3D &&
+        kernel.getOption(vISA_LocalRA))
     {
         kernel.getOptions()->setOption(vISAOptions::vISA_LocalRA, false);
     }
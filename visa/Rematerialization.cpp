@@ -25,6 +25,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 
 #include "Rematerialization.h"
+#include "LocalScheduler/LatencyTable.h"
+#include <memory>
 
 namespace vISA
 {
@@ -1004,6 +1006,28 @@ namespace vISA
 
         populateRefs();
 
+        // Remat stats of spilled ranges are only used by the report
+        bool reportDecisions = kernel.fg.builder->getOption(vISA_OptReport) ||
+            kernel.fg.builder->getOption(vISA_RATrace);
+        std::unique_ptr<LatencyTable> LT;
+        if (reportDecisions)
+        {
+            std::vector<bool> cheapRematRanges;
+            getCheapRematRanges(kernel, liveness, cheapRematRanges);
+            for (auto dcl : spills)
+            {
+                auto& stats = spillRematStats[dcl];
+                auto opIt = operations.find(dcl);
+                if (opIt != operations.end())
+                {
+                    stats.numDefs = (unsigned int)(*opIt).second.def.size();
+                    stats.numUses = (*opIt).second.numUses;
+                }
+                stats.cheapRemat = cheapRematRanges[dcl->getRegVar()->getId()];
+            }
+            LT.reset(new LatencyTable(kernel.getOptions()));
+        }
+
         for (auto bb : kernel.fg.BBs)
         {
             // Store cache of rematerialized operations so nearby instructions
@@ -1093,6 +1117,19 @@ namespace vISA
                                 std::list<G4_INST*> newInsts;
                                 G4_INST* cacheInst = nullptr;
                                 rematSrc = rematerialize(src->asSrcRegRegion(), bb, uniqueDef, newInsts, cacheInst);
+
+                                auto statsIt = spillRematStats.find(src->getTopDcl());
+                                if (reportDecisions && statsIt != spillRematStats.end())
+                                {
+                                    for (auto newInst : newInsts)
+                                    {
+                                        if (!newInst->isPseudoKill())
+                                        {
+                                            (*statsIt).second.rematCycles += LT->getLatency(newInst).getSum();
+                                        }
+                                    }
+                                }
+
                                 while (!newInsts.empty())
                                 {
                                     bb->instList.insert(instIt, newInsts.front());
@@ -1106,6 +1143,12 @@ namespace vISA
                                 IRChanged = true;
                             }
 
+                            auto statsIt = spillRematStats.find(src->getTopDcl());
+                            if (statsIt != spillRematStats.end())
+                            {
+                                (*statsIt).second.numRematUses++;
+                            }
+
                             inst->setSrc(rematSrc, opnd);
                         }
                     }
@@ -1120,9 +1163,165 @@ namespace vISA
             kernel.dumpDotFile("after.remat");
         }
 
+        if (reportDecisions)
+        {
+            reportRematDecisions();
+        }
+
         //unsigned int after = getNumSamplers(kernel);
     }
 
+    void Rematerialization::getCheapRematRanges(G4_Kernel& kernel, LivenessAnalysis& liveness, std::vector<bool>& cheapRemat)
+    {
+        // A range is cheap to remat when it has a single def that reads
+        // only immediates, so recomputing it at a use extends no other
+        // range. Def is required to be outside loops and have few uses
+        // to match conditions under which canRematerialize remats a
+        // spilled range.
+        unsigned int numVars = liveness.getNumSelectedVar();
+        cheapRemat.assign(numVars, false);
+
+        std::vector<unsigned int> numDefs(numVars, 0);
+        std::vector<unsigned int> numUses(numVars, 0);
+        std::vector<bool> immDef(numVars, false);
+
+        std::set<G4_BB*> bbsInLoop;
+        for (auto&& loop : kernel.fg.naturalLoops)
+        {
+            bbsInLoop.insert(loop.second.begin(), loop.second.end());
+        }
+
+        for (auto bb : kernel.fg.BBs)
+        {
+            bool bbInLoop = bbsInLoop.find(bb) != bbsInLoop.end();
+            for (auto inst : bb->instList)
+            {
+                if (inst->isPseudoKill())
+                    continue;
+
+                auto dst = inst->getDst();
+                if (dst && !dst->isNullReg() &&
+                    dst->getTopDcl() &&
+                    dst->getTopDcl()->getRegVar()->isRegAllocPartaker())
+                {
+                    unsigned int id = dst->getTopDcl()->getRegVar()->getId();
+                    numDefs[id]++;
+
+                    bool allSrcsImm = true;
+                    for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+                    {
+                        auto srcOpnd = inst->getSrc(i);
+                        if (srcOpnd && !srcOpnd->isImm() && !srcOpnd->isNullReg())
+                        {
+                            allSrcsImm = false;
+                            break;
+                        }
+                    }
+
+                    immDef[id] = allSrcsImm &&
+                        !bbInLoop &&
+                        !inst->isSend() &&
+                        !inst->getPredicate() &&
+                        !inst->getCondMod() &&
+                        isRematCandidateOp(inst) &&
+                        (!bb->isInSimdFlow() || inst->isWriteEnableInst());
+                }
+
+                for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+                {
+                    auto srcOpnd = inst->getSrc(i);
+                    if (srcOpnd &&
+                        srcOpnd->isSrcRegRegion() &&
+                        srcOpnd->getTopDcl() &&
+                        srcOpnd->getTopDcl()->getRegVar()->isRegAllocPartaker())
+                    {
+                        numUses[srcOpnd->getTopDcl()->getRegVar()->getId()]++;
+                    }
+                }
+            }
+        }
+
+        for (unsigned int id = 0; id != numVars; id++)
+        {
+            auto dcl = liveness.vars[id]->getDeclare();
+            cheapRemat[id] = numDefs[id] == 1 &&
+                immDef[id] &&
+                numUses[id] > 0 &&
+                numUses[id] <= MAX_USES_REMAT &&
+                !dcl->getAddressed() &&
+                !dcl->isInput() &&
+                !dcl->getSpilledDeclare() &&
+                (dcl->getRegFile() & G4_RegFileKind::G4_GRF) != 0x0;
+        }
+    }
+
+    void Rematerialization::reportRematDecisions()
+    {
+        // For each spilled range report whether its uses were remat'd
+        // or will be filled. Cycles saved are estimated as scratch
+        // messages avoided minus latency of remat'd instructions.
+        LatencyTable LT(kernel.getOptions());
+        unsigned int scratchLatency = LT.getSendLatency(SFID_DP_DC).getSum();
+
+        std::ofstream optreport;
+        bool toOptReport = kernel.fg.builder->getOption(vISA_OptReport);
+        if (toOptReport)
+        {
+            getOptReportStream(optreport, kernel.getOptions());
+            optreport << "             === Remat vs Spill ===" << std::endl;
+        }
+
+        unsigned int numRemat = 0, numSpill = 0;
+        int totalCyclesSaved = 0;
+        for (auto dcl : spills)
+        {
+            auto& stats = spillRematStats[dcl];
+
+            const char* decision = "spill";
+            int cyclesSaved = (int)(stats.numRematUses * scratchLatency) - (int)stats.rematCycles;
+            if (stats.numRematUses > 0 &&
+                stats.numRematUses >= stats.numUses)
+            {
+                // All uses remat'd so spill stores are avoided as well
+                decision = "remat";
+                cyclesSaved += (int)(stats.numDefs * scratchLatency);
+                numRemat++;
+            }
+            else if (stats.numRematUses > 0)
+            {
+                decision = "partial remat";
+                numSpill++;
+            }
+            else
+            {
+                numSpill++;
+            }
+
+            totalCyclesSaved += cyclesSaved;
+
+            if (toOptReport)
+            {
+                optreport << dcl->getName() << ": " << decision <<
+                    (stats.cheapRemat ? " (cheap remat)" : "") <<
+                    ", uses remat'd " << stats.numRematUses << "/" << stats.numUses <<
+                    ", est. cycles saved " << cyclesSaved << std::endl;
+            }
+        }
+
+        if (toOptReport)
+        {
+            optreport << kernel.getName() << ": " << numRemat << " remat'd, " << numSpill <<
+                " spilled, est. cycles saved " << totalCyclesSaved << std::endl << std::endl;
+            closeOptReportStream(optreport);
+        }
+
+        if (kernel.fg.builder->getOption(vISA_RATrace))
+        {
+            std::cout << "\t--remat/spill: " << numRemat << "/" << numSpill <<
+                ", est. cycles saved: " << totalCyclesSaved << "\n";
+        }
+    }
+
     void Dominators::computeDominators()
     {
         // Compute all doms for given bb.
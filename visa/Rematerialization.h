@@ -70,6 +70,17 @@ namespace vISA
         std::unordered_set<unsigned int> rowsUsed;
     };
 
+    // Remat vs. spill decision for a spilled range, used for opt report
+    struct RematStats
+    {
+        unsigned int numDefs = 0;
+        unsigned int numUses = 0;
+        unsigned int numRematUses = 0;
+        // Estimated cycles of instructions inserted by remat
+        unsigned int rematCycles = 0;
+        bool cheapRemat = false;
+    };
+
     class Dominators
     {
     private:
@@ -126,6 +137,8 @@ namespace vISA
         // Map BB->subroutine it belongs to
         // BBs not present are assumed to belong to main kernel
         std::unordered_map<G4_BB*, const FuncInfo*> BBPerSubroutine;
+        // Remat stats of each spilled dcl
+        std::unordered_map<G4_Declare*, RematStats> spillRematStats;
 
         void populateRefs();
         void populateSamplerHeaderMap();
@@ -187,7 +200,7 @@ namespace vISA
             return 0;
         }
 
-        bool isRematCandidateOp(G4_INST* inst)
+        static bool isRematCandidateOp(G4_INST* inst)
         {
             if (inst->isFlowControl() || inst->isWait() || inst->isFence() ||
                 inst->isLifeTimeEnd() || inst->isAccDstInst() || inst->isAccSrcInst() ||
@@ -200,6 +213,7 @@ namespace vISA
         }
 
         void cleanRedundantSamplerHeaders();
+        void reportRematDecisions();
 
         unsigned int getNumRematsInLoop() { return numRematsInLoop; }
         void incNumRematsInLoop() { numRematsInLoop++; }
@@ -287,6 +301,11 @@ namespace vISA
         bool getChangesMade() { return IRChanged; }
 
         void run();
+
+        // Compute ranges that remat can recompute at their uses
+        // without extending any other range. Used to lower spill
+        // cost of such ranges in GraphColor::computeSpillCosts.
+        static void getCheapRematRanges(G4_Kernel&, LivenessAnalysis&, std::vector<bool>&);
     };
 }
 #endif
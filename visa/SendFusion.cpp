@@ -47,7 +47,12 @@ namespace vISA
 
 			// Control how many instructions except send itself need to
 			// be moved in order to move two sends together for fusion.
-			SEND_FUSION_MAX_INST_TOBEMOVED = 4
+			SEND_FUSION_MAX_INST_TOBEMOVED = 4,
+
+			// Control how many times fusion is repeated on a BB. Each
+			// round doubles exec size of fused sends, so N-way fusion
+			// of send(1) goes up to send(16) in 4 rounds.
+			SEND_FUSION_MAX_ROUNDS = 4
         };
 
         FlowGraph* CFG;
@@ -129,6 +134,9 @@ namespace vISA
         uint32_t getFuncCtrlWithSimd16(G4_SendMsgDescriptor* Desc);
         void simplifyMsg(INST_LIST_ITER SendIter);
 
+        // One round of fusion on CurrBB
+        bool runOnce();
+
 		bool WAce0Read;
 
 
@@ -146,7 +154,9 @@ namespace vISA
             initDMaskModInfo();
         }
 
+        // Fuse sends in BB, repeating until no more fusion can be done.
         bool run(G4_BB* BB);
+        bool hoistSendsFromFallThrough(G4_BB* BB, G4_BB* SuccBB);
 	};
 }
 
@@ -1331,10 +1341,26 @@ void SendFusion::doFusion(
 
 bool SendFusion::run(G4_BB* BB)
 {
-    // Prepare for processing this BB
     CurrBB = BB;
+    bool BBChanged = false;
+    for (int round = 0; round < SEND_FUSION_MAX_ROUNDS; ++round)
+    {
+        if (!runOnce())
+        {
+            break;
+        }
+        BBChanged = true;
+    }
+    return BBChanged;
+}
+
+bool SendFusion::runOnce()
+{
+    // Prepare for processing this round. Flag is re-created as
+    // a fusion in this round might precede the previous flag def.
     FlagDefPerBB = nullptr;
     CurrBB->resetLocalId();
+    changed = false;
 
     // Found two candidate sends:
     //    1. next to each (no other sends in between), and
@@ -1423,6 +1449,131 @@ bool SendFusion::run(G4_BB* BB)
     return changed;
 }
 
+// Move the first candidate send of SuccBB to the end of BB if it can be
+// fused with a send at the end of BB. This is done only if both BBs run
+// with the same channel mask, ie:
+//   1. BB falls through to SuccBB and has no other successor,
+//   2. SuccBB has BB as its only predecessor, and
+//   3. there is no goto/join (or any control flow) in between.
+// Return true if a send is moved.
+bool SendFusion::hoistSendsFromFallThrough(G4_BB* BB, G4_BB* SuccBB)
+{
+    if (BB->instList.empty() ||
+        BB->instList.back()->isFlowControl() ||
+        BB->getBBType() != G4_BB_NONE_TYPE ||
+        SuccBB->getBBType() != G4_BB_NONE_TYPE ||
+        BB->Succs.size() != 1 || BB->Succs.front() != SuccBB ||
+        SuccBB->Preds.size() != 1)
+    {
+        return false;
+    }
+
+    // Find the last candidate in BB that is not followed
+    // by any memory instruction.
+    CurrBB = BB;
+    CurrBB->resetLocalId();
+    G4_INST* lastSend = nullptr;
+    INST_LIST_ITER lastSendIt;
+    for (auto II = BB->instList.rbegin(), IE = BB->instList.rend(); II != IE; ++II)
+    {
+        G4_INST* tmp = *II;
+        G4_DstRegRegion* Dst = tmp->getDst();
+        if (tmp->isSend())
+        {
+            // simplifyAndCheckCandidate() takes a forward iterator
+            INST_LIST_ITER sendIt = II.base();
+            --sendIt;
+            if (simplifyAndCheckCandidate(sendIt))
+            {
+                lastSend = tmp;
+                lastSendIt = sendIt;
+            }
+            break;
+        }
+
+        if (tmp->isFence() ||
+            (tmp->isOptBarrier() && Dst && Dst->isAreg() && Dst->isSrReg()))
+        {
+            break;
+        }
+    }
+
+    if (lastSend == nullptr)
+    {
+        return false;
+    }
+
+    CurrBB = SuccBB;
+    CurrBB->resetLocalId();
+    int span = 0;
+    for (INST_LIST_ITER II = SuccBB->instList.begin(), IE = SuccBB->instList.end();
+         II != IE && span < SEND_FUSION_MAX_SPAN;
+         ++II, ++span)
+    {
+        G4_INST* tmp = *II;
+        if (tmp->isLabel())
+        {
+            continue;
+        }
+
+        G4_DstRegRegion* Dst = tmp->getDst();
+        if (tmp->isFlowControl() || tmp->isFence() ||
+            (tmp->isOptBarrier() && Dst && Dst->isAreg() && Dst->isSrReg()))
+        {
+            return false;
+        }
+
+        if (!tmp->isSend())
+        {
+            continue;
+        }
+
+        if (tmp->opcode() != lastSend->opcode() ||
+            tmp->getExecSize() != lastSend->getExecSize() ||
+            tmp->getOption() != lastSend->getOption() ||
+            !simplifyAndCheckCandidate(II) ||
+            tmp->getMsgDesc()->getDesc() != lastSend->getMsgDesc()->getDesc() ||
+            tmp->getMsgDesc()->getExtendedDesc() != lastSend->getMsgDesc()->getExtendedDesc() ||
+            !canFusion(lastSendIt, II))
+        {
+            // Only move a send that has a fusion partner.
+            return false;
+        }
+
+        // Send must not depend on any instruction it moves over.
+        for (INST_LIST_ITER PI = SuccBB->instList.begin(); PI != II; ++PI)
+        {
+            G4_INST* prev = *PI;
+            if (tmp->isWARdep(prev) || tmp->isWAWdep(prev) || tmp->isRAWdep(prev))
+            {
+                return false;
+            }
+        }
+
+        SuccBB->instList.erase(II);
+        BB->instList.push_back(tmp);
+        return true;
+    }
+
+    return false;
+}
+
+static unsigned int getNumSends(FlowGraph* aCFG)
+{
+    unsigned int numSends = 0;
+    for (auto BB : aCFG->BBs)
+    {
+        for (auto Inst : BB->instList)
+        {
+            if (Inst->isSend())
+            {
+                ++numSends;
+            }
+        }
+    }
+    return numSends;
+}
+
 //
 // The main goal is to do the following for SIMD8 shader:
 //
@@ -1430,7 +1581,10 @@ bool SendFusion::run(G4_BB* BB)
 //
 //      Either noMask or not. When no NoMask
 //
-// Note that (w) send(1|2|4) is also supported.
+// Note that (w) send(1|2|4) is also supported. Fusion is repeated on each
+// BB so that N sends of (w) send(1|2|4) are fused into one send of up to
+// 16 channels. Sends at the start of a fall-through BB with the same
+// channel mask are fused with sends at the end of its predecessor.
 //
 bool vISA::doSendFusion(FlowGraph* aCFG, Mem_Manager* aMMgr)
 {
@@ -1442,13 +1596,35 @@ bool vISA::doSendFusion(FlowGraph* aCFG, Mem_Manager* aMMgr)
 
 	SendFusion sendFusion(aCFG, aMMgr);
 
+    bool optReport = aCFG->builder->getOption(vISA_OptReport);
+    unsigned int numSendsBefore = optReport ? getNumSends(aCFG) : 0;
+
     bool change = false;
     for (BB_LIST_ITER BI = aCFG->BBs.begin(), BE = aCFG->BBs.end(); BI != BE; ++BI)
     {
         G4_BB* BB = *BI;
-	    if (sendFusion.run(BB)) {
+        BB_LIST_ITER NextBI = BI;
+        ++NextBI;
+        if (NextBI != BE &&
+            sendFusion.hoistSendsFromFallThrough(BB, *NextBI))
+        {
+            change = true;
+        }
+
+        if (sendFusion.run(BB))
+        {
             change = true;
         }
     }
+
+    if (optReport)
+    {
+        std::ofstream optReportStream;
+        getOptReportStream(optReportStream, aCFG->builder->getOptions());
+        optReportStream << "             === Send Fusion ===" << endl;
+        optReportStream << aCFG->getKernel()->getName() << ": sends reduced from "
+            << numSendsBefore << " to " << getNumSends(aCFG) << endl << endl;
+        closeOptReportStream(optReportStream);
+    }
 	return change;
 }
@@ -2043,10 +2043,703 @@ void CoalesceSpillFills::removeRedundantWrites()
     }
 }
 
+unsigned int CoalesceSpillFills::getNumScratchMsgs()
+{
+    unsigned int numScratchMsgs = 0;
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : bb->instList)
+        {
+            if (inst->isSend() &&
+                inst->getMsgDesc()->isScratchRW())
+            {
+                numScratchMsgs++;
+            }
+        }
+    }
+
+    return numScratchMsgs;
+}
+
+std::vector<G4_BB*> CoalesceSpillFills::getLoopBBsInLayoutOrder(const FlowGraph::Blocks& loopBody)
+{
+    // Loop bodies are ordered by BB address. Walk them in layout
+    // order instead so that placement is the same from run to run.
+    std::vector<G4_BB*> loopBBs;
+    loopBBs.reserve(loopBody.size());
+    for (auto bb : kernel.fg.BBs)
+    {
+        if (loopBody.find(bb) != loopBody.end())
+        {
+            loopBBs.push_back(bb);
+        }
+    }
+
+    return loopBBs;
+}
+
+unsigned int CoalesceSpillFills::getLoopPressure(const FlowGraph::Blocks& loopBody)
+{
+    // RPE was computed before spill code was inserted, so pressure
+    // of original instructions is a conservative estimate for loop.
+    unsigned int maxPressure = 0;
+    for (auto bb : loopBody)
+    {
+        unsigned int bbPressure = 0;
+        for (auto inst : bb->instList)
+        {
+            bbPressure = std::max(bbPressure, rpe.getRegisterPressure(inst));
+        }
+
+        auto it = placementPressure.find(bb);
+        if (it != placementPressure.end())
+        {
+            bbPressure += it->second;
+        }
+
+        maxPressure = std::max(maxPressure, bbPressure);
+    }
+
+    return maxPressure;
+}
+
+bool CoalesceSpillFills::dominatesExits(const FlowGraph::Blocks& loopBody, G4_BB* header,
+    G4_BB* bb, const std::set<G4_BB*>& exitingBBs)
+{
+    // Loop is entered only via header, so bb dominates an exiting
+    // BB if latter is unreachable from header when bb is removed.
+    if (bb == header)
+    {
+        return true;
+    }
+
+    std::set<G4_BB*> visited;
+    std::list<G4_BB*> worklist;
+    worklist.push_back(header);
+    visited.insert(header);
+    while (!worklist.empty())
+    {
+        auto curBB = worklist.front();
+        worklist.pop_front();
+
+        if (exitingBBs.find(curBB) != exitingBBs.end())
+        {
+            return false;
+        }
+
+        for (auto succ : curBB->Succs)
+        {
+            if (succ == bb ||
+                loopBody.find(succ) == loopBody.end() ||
+                visited.find(succ) != visited.end())
+            {
+                continue;
+            }
+
+            visited.insert(succ);
+            worklist.push_back(succ);
+        }
+    }
+
+    return true;
+}
+
+void CoalesceSpillFills::hoistLoopFills(const FlowGraph::Blocks& loopBody, G4_BB* preheader,
+    std::unordered_map<G4_Declare*, unsigned int>& numDefs)
+{
+    // Hoist fills of scratch slots that are never written
+    // in the loop to preheader:
+    //
+    // preheader:
+    // ..
+    // loop:
+    // fill FP1 from offset = 1
+    // = FP1
+    // (p) jmpi loop
+    // ===>
+    // preheader:
+    // fill FP1 from offset = 1
+    // loop:
+    // = FP1
+    // (p) jmpi loop
+    //
+    std::set<unsigned int> writtenRows;
+    for (auto bb : loopBody)
+    {
+        for (auto inst : bb->instList)
+        {
+            if (inst->isSend() &&
+                inst->getMsgDesc()->isScratchWrite())
+            {
+                unsigned int rowStart, numRows;
+                getScratchMsgInfo(inst, rowStart, numRows);
+                for (unsigned int row = rowStart; row != (rowStart + numRows); row++)
+                {
+                    writtenRows.insert(row);
+                }
+            }
+        }
+    }
+
+    unsigned int loopPressure = getLoopPressure(loopBody);
+
+    auto insertIt = preheader->instList.end();
+    if (!preheader->instList.empty() &&
+        preheader->instList.back()->isFlowControl())
+    {
+        insertIt--;
+    }
+
+    std::set<G4_Declare*> hoistedDcls;
+    for (auto bb : getLoopBBsInLayoutOrder(loopBody))
+    {
+        for (auto instIt = bb->instList.begin();
+            instIt != bb->instList.end();
+            )
+        {
+            auto inst = (*instIt);
+
+            if (!inst->isSend() ||
+                !inst->getMsgDesc()->isScratchRead() ||
+                !inst->isWriteEnableInst())
+            {
+                instIt++;
+                continue;
+            }
+
+            auto dcl = inst->getDst()->getTopDcl();
+            if (!dcl ||
+                numDefs[dcl] != 1 ||
+                addrTakenSpillFillDcl.find(dcl) != addrTakenSpillFillDcl.end())
+            {
+                instIt++;
+                continue;
+            }
+
+            unsigned int rowStart, numRows;
+            getScratchMsgInfo(inst, rowStart, numRows);
+            bool isWritten = false;
+            for (unsigned int row = rowStart; row != (rowStart + numRows); row++)
+            {
+                if (writtenRows.find(row) != writtenRows.end())
+                {
+                    isWritten = true;
+                    break;
+                }
+            }
+
+            if (isWritten ||
+                loopPressure + dcl->getNumRows() > loopPlacementThreshold)
+            {
+                instIt++;
+                continue;
+            }
+
+#if 0
+            printf("Hoisting fill at $%d from BB%d to BB%d\n", inst->getCISAOff(), bb->getId(), preheader->getId());
+#endif
+            loopPressure += dcl->getNumRows();
+            preheader->instList.insert(insertIt, inst);
+            instIt = bb->instList.erase(instIt);
+            hoistedDcls.insert(dcl);
+        }
+    }
+
+    if (hoistedDcls.empty())
+    {
+        return;
+    }
+
+    // Hoisted fill dsts are live throughout loop so
+    // remove their pseudo-kills in loop.
+    for (auto bb : loopBody)
+    {
+        for (auto instIt = bb->instList.begin();
+            instIt != bb->instList.end();
+            )
+        {
+            auto inst = (*instIt);
+            if (inst->isPseudoKill() &&
+                hoistedDcls.find(inst->getDst()->getTopDcl()) != hoistedDcls.end())
+            {
+                instIt = bb->instList.erase(instIt);
+                continue;
+            }
+            instIt++;
+        }
+    }
+
+    unsigned int hoistedRows = 0;
+    for (auto dcl : hoistedDcls)
+    {
+        hoistedRows += dcl->getNumRows();
+    }
+
+    placementPressure[preheader] += hoistedRows;
+    for (auto bb : loopBody)
+    {
+        placementPressure[bb] += hoistedRows;
+    }
+}
+
+void CoalesceSpillFills::sinkLoopSpills(const FlowGraph::Blocks& loopBody, G4_BB* header,
+    std::unordered_map<G4_Declare*, unsigned int>& numDefs)
+{
+    // Sink spills of scratch slots that are never read in
+    // loop to the loop exit. Only the value written in last
+    // iteration is observable after loop. This is legal when:
+    // 1. Loop has a single exit BB whose preds are all in loop,
+    // 2. Spill is the only write to its slots in loop,
+    // 3. All defs of spilled payload precede spill in its BB,
+    // 4. Spill BB dominates all exiting BBs of loop.
+    G4_BB* exitBB = nullptr;
+    std::set<G4_BB*> exitingBBs;
+    for (auto bb : loopBody)
+    {
+        if (bb->getBBType() & (G4_BB_CALL_TYPE | G4_BB_RETURN_TYPE))
+        {
+            return;
+        }
+
+        for (auto succ : bb->Succs)
+        {
+            if (loopBody.find(succ) != loopBody.end())
+            {
+                continue;
+            }
+
+            if (exitBB && exitBB != succ)
+            {
+                return;
+            }
+
+            exitBB = succ;
+            exitingBBs.insert(bb);
+        }
+    }
+
+    if (!exitBB ||
+        exitBB->getBBType() != G4_BB_NONE_TYPE)
+    {
+        return;
+    }
+
+    for (auto pred : exitBB->Preds)
+    {
+        if (loopBody.find(pred) == loopBody.end())
+        {
+            return;
+        }
+    }
+
+    std::map<unsigned int, unsigned int> numWritesPerRow;
+    std::set<unsigned int> readRows;
+    for (auto bb : loopBody)
+    {
+        for (auto inst : bb->instList)
+        {
+            if (inst->isSend() &&
+                inst->getMsgDesc()->isScratchRW())
+            {
+                unsigned int rowStart, numRows;
+                getScratchMsgInfo(inst, rowStart, numRows);
+                bool isRead = inst->getMsgDesc()->isScratchRead();
+                for (unsigned int row = rowStart; row != (rowStart + numRows); row++)
+                {
+                    if (isRead)
+                        readRows.insert(row);
+                    else
+                        numWritesPerRow[row]++;
+                }
+            }
+        }
+    }
+
+    unsigned int loopPressure = getLoopPressure(loopBody);
+
+    auto insertIt = exitBB->instList.begin();
+    while (insertIt != exitBB->instList.end() &&
+        ((*insertIt)->isLabel() || (*insertIt)->opcode() == G4_join))
+    {
+        insertIt++;
+    }
+
+    unsigned int sunkRows = 0;
+    for (auto bb : getLoopBBsInLayoutOrder(loopBody))
+    {
+        if (!dominatesExits(loopBody, header, bb, exitingBBs))
+        {
+            continue;
+        }
+
+        // Number of defs seen for each payload so far in bb
+        std::unordered_map<G4_Declare*, unsigned int> defsSeen;
+        std::list<INST_LIST_ITER> spillsToSink;
+        for (auto instIt = bb->instList.begin();
+            instIt != bb->instList.end();
+            instIt++)
+        {
+            auto inst = (*instIt);
+
+            if (inst->getDst() &&
+                inst->getDst()->getTopDcl() &&
+                !inst->isPseudoKill())
+            {
+                auto dstDcl = inst->getDst()->getTopDcl();
+                defsSeen[dstDcl]++;
+
+                // A def after spill invalidates it
+                for (auto spillIt = spillsToSink.begin();
+                    spillIt != spillsToSink.end();
+                    )
+                {
+                    if ((*(*spillIt))->getSrc(1)->getTopDcl() == dstDcl)
+                    {
+                        spillIt = spillsToSink.erase(spillIt);
+                        continue;
+                    }
+                    spillIt++;
+                }
+            }
+
+            if (!inst->isSplitSend() ||
+                !inst->getMsgDesc()->isScratchWrite() ||
+                !inst->isWriteEnableInst())
+            {
+                continue;
+            }
+
+            auto payloadDcl = inst->getSrc(1)->getTopDcl();
+            if (!payloadDcl ||
+                defsSeen[payloadDcl] == 0 ||
+                defsSeen[payloadDcl] != numDefs[payloadDcl] ||
+                addrTakenSpillFillDcl.find(payloadDcl) != addrTakenSpillFillDcl.end())
+            {
+                continue;
+            }
+
+            unsigned int rowStart, numRows;
+            getScratchMsgInfo(inst, rowStart, numRows);
+            bool canSink = true;
+            for (unsigned int row = rowStart; row != (rowStart + numRows); row++)
+            {
+                if (readRows.find(row) != readRows.end() ||
+                    numWritesPerRow[row] != 1)
+                {
+                    canSink = false;
+                    break;
+                }
+            }
+
+            if (canSink)
+            {
+                spillsToSink.push_back(instIt);
+            }
+        }
+
+        for (auto spillIt : spillsToSink)
+        {
+            auto inst = (*spillIt);
+            auto payloadRows = inst->getSrc(1)->getTopDcl()->getNumRows();
+            if (loopPressure + payloadRows > loopPlacementThreshold)
+            {
+                continue;
+            }
+
+#if 0
+            printf("Sinking spill at $%d from BB%d to BB%d\n", inst->getCISAOff(), bb->getId(), exitBB->getId());
+#endif
+            loopPressure += payloadRows;
+            sunkRows += payloadRows;
+            exitBB->instList.insert(insertIt, inst);
+            bb->instList.erase(spillIt);
+        }
+    }
+
+    if (sunkRows > 0)
+    {
+        placementPressure[exitBB] += sunkRows;
+        for (auto bb : loopBody)
+        {
+            placementPressure[bb] += sunkRows;
+        }
+    }
+}
+
+void CoalesceSpillFills::moveFillsToFallThroughPred()
+{
+    // Fills at the start of a BB whose only pred falls through
+    // in to it are moved to end of pred. This allows coalescing
+    // them with fills at the end of pred:
+    //
+    // BB1:
+    // fill FP1 from offset = 1
+    // = FP1
+    // BB2:
+    // fill FP2 from offset = 2
+    // = FP2
+    // ===>
+    // BB1:
+    // fill FP1 from offset = 1
+    // = FP1
+    // fill FP2 from offset = 2
+    // BB2:
+    // = FP2
+    //
+    for (auto bbIt = kernel.fg.BBs.begin();
+        bbIt != kernel.fg.BBs.end();
+        bbIt++)
+    {
+        auto bb = (*bbIt);
+        auto nextIt = bbIt;
+        nextIt++;
+        if (nextIt == kernel.fg.BBs.end())
+        {
+            break;
+        }
+
+        auto succ = (*nextIt);
+        if (bb->instList.empty() ||
+            bb->instList.back()->isFlowControl() ||
+            bb->getBBType() != G4_BB_NONE_TYPE ||
+            succ->getBBType() != G4_BB_NONE_TYPE ||
+            bb->Succs.size() != 1 ||
+            bb->Succs.front() != succ ||
+            succ->Preds.size() != 1)
+        {
+            continue;
+        }
+
+        // Check whether there is a fill at end of bb to coalesce with
+        bool tailHasFill = false;
+        unsigned int w = 0;
+        for (auto instIt = bb->instList.rbegin();
+            instIt != bb->instList.rend() && w < cWindowSize;
+            instIt++, w++)
+        {
+            auto inst = (*instIt);
+            if (inst->isSend() &&
+                inst->getMsgDesc()->isScratchRead())
+            {
+                tailHasFill = true;
+                break;
+            }
+        }
+
+        if (!tailHasFill)
+        {
+            continue;
+        }
+
+        std::set<unsigned int> writtenRows;
+        std::set<G4_Declare*> dclsSeen;
+        std::map<G4_Declare*, INST_LIST_ITER> pseudoKills;
+        std::list<INST_LIST_ITER> fillsToMove;
+        w = 0;
+        for (auto instIt = succ->instList.begin();
+            instIt != succ->instList.end() && w < cWindowSize;
+            instIt++)
+        {
+            auto inst = (*instIt);
+
+            if (inst->isLabel())
+            {
+                continue;
+            }
+
+            if (inst->isFlowControl() ||
+                rpe.getRegisterPressure(inst) > fillWindowSizeThreshold)
+            {
+                break;
+            }
+
+            if (inst->isPseudoKill())
+            {
+                pseudoKills[inst->getDst()->getTopDcl()] = instIt;
+                continue;
+            }
+
+            w++;
+
+            if (inst->isSend() &&
+                inst->getMsgDesc()->isScratchRead() &&
+                inst->isWriteEnableInst())
+            {
+                auto dcl = inst->getDst()->getTopDcl();
+                unsigned int rowStart, numRows;
+                getScratchMsgInfo(inst, rowStart, numRows);
+                bool canMove = dclsSeen.find(dcl) == dclsSeen.end() &&
+                    addrTakenSpillFillDcl.find(dcl) == addrTakenSpillFillDcl.end();
+                for (unsigned int row = rowStart; row != (rowStart + numRows) && canMove; row++)
+                {
+                    if (writtenRows.find(row) != writtenRows.end())
+                    {
+                        canMove = false;
+                    }
+                }
+
+                if (canMove)
+                {
+                    fillsToMove.push_back(instIt);
+                    continue;
+                }
+            }
+
+            if (inst->isSend() &&
+                inst->getMsgDesc()->isScratchWrite())
+            {
+                unsigned int rowStart, numRows;
+                getScratchMsgInfo(inst, rowStart, numRows);
+                for (unsigned int row = rowStart; row != (rowStart + numRows); row++)
+                {
+                    writtenRows.insert(row);
+                }
+            }
+
+            if (inst->getDst() &&
+                inst->getDst()->getTopDcl())
+            {
+                dclsSeen.insert(inst->getDst()->getTopDcl());
+            }
+
+            for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+            {
+                G4_Operand* opnd = inst->getSrc(i);
+                if (opnd &&
+                    opnd->getTopDcl())
+                {
+                    dclsSeen.insert(opnd->getTopDcl());
+                }
+            }
+        }
+
+        for (auto fillIt : fillsToMove)
+        {
+            auto inst = (*fillIt);
+            auto killIt = pseudoKills.find(inst->getDst()->getTopDcl());
+            if (killIt != pseudoKills.end())
+            {
+                bb->instList.push_back(*(killIt->second));
+                succ->instList.erase(killIt->second);
+            }
+
+#if 0
+            printf("Moving fill at $%d from BB%d to BB%d\n", inst->getCISAOff(), succ->getId(), bb->getId());
+#endif
+            bb->instList.push_back(inst);
+            succ->instList.erase(fillIt);
+        }
+    }
+}
+
+void CoalesceSpillFills::spillFillPlacement()
+{
+    if (kernel.fg.getHasStackCalls() ||
+        kernel.fg.getIsStackCallFunc())
+    {
+        return;
+    }
+
+    std::unordered_map<G4_Declare*, unsigned int> numDefs;
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : bb->instList)
+        {
+            if (inst->getDst() &&
+                inst->getDst()->getTopDcl() &&
+                !inst->isPseudoKill())
+            {
+                numDefs[inst->getDst()->getTopDcl()]++;
+            }
+        }
+    }
+
+    // Visit inner loops first so that fills hoisted
+    // to an inner preheader can be hoisted further.
+    std::vector<std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>> loops;
+    for (auto& loop : kernel.fg.naturalLoops)
+    {
+        loops.push_back(std::make_pair(loop.first, &loop.second));
+    }
+    std::stable_sort(loops.begin(), loops.end(),
+        [](const std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>& l1,
+            const std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>& l2)
+    {
+        // Loops are keyed by BB address, so break ties by BB id
+        // to keep the visiting order deterministic.
+        if (l1.second->size() != l2.second->size())
+        {
+            return l1.second->size() < l2.second->size();
+        }
+        if (l1.first.second->getId() != l2.first.second->getId())
+        {
+            return l1.first.second->getId() < l2.first.second->getId();
+        }
+        return l1.first.first->getId() < l2.first.first->getId();
+    });
+
+    for (auto& loop : loops)
+    {
+        auto header = loop.first.second;
+        auto& loopBody = *loop.second;
+
+        bool hasCall = false;
+        for (auto bb : loopBody)
+        {
+            if (bb->getBBType() & (G4_BB_CALL_TYPE | G4_BB_RETURN_TYPE) ||
+                bb->isEndWithFCall())
+            {
+                hasCall = true;
+                break;
+            }
+        }
+
+        if (hasCall)
+        {
+            continue;
+        }
+
+        G4_BB* preheader = nullptr;
+        unsigned int numOutsidePreds = 0;
+        for (auto pred : header->Preds)
+        {
+            if (loopBody.find(pred) == loopBody.end())
+            {
+                preheader = pred;
+                numOutsidePreds++;
+            }
+        }
+
+        if (numOutsidePreds == 1 &&
+            preheader->Succs.size() == 1 &&
+            preheader->getBBType() == G4_BB_NONE_TYPE)
+        {
+            hoistLoopFills(loopBody, preheader, numDefs);
+        }
+
+        sinkLoopSpills(loopBody, header, numDefs);
+    }
+
+    moveFillsToFallThroughPred();
+}
+
 void CoalesceSpillFills::run()
 {
+    bool globalPlacement = kernel.getOptions()->getOption(vISA_GlobalSpillPlacement);
+    unsigned int numScratchMsgsBefore = 0;
+    if (globalPlacement &&
+        kernel.getOptions()->getOption(vISA_RATrace))
+    {
+        numScratchMsgsBefore = getNumScratchMsgs();
+    }
+
     removeRedundantSplitMovs();
 
+    if (globalPlacement)
+    {
+        spillFillPlacement();
+    }
+
     fills();
     replaceMap.clear();
     spills();
@@ -2056,6 +2749,13 @@ void CoalesceSpillFills::run()
     removeRedundantWrites();
 
     fixSendsSrcOverlap();
+
+    if (globalPlacement &&
+        kernel.getOptions()->getOption(vISA_RATrace))
+    {
+        std::cout << "\t--scratch msgs before/after spill cleanup: " << numScratchMsgsBefore <<
+            "/" << getNumScratchMsgs() << "\n";
+    }
 }
 
 void CoalesceSpillFills::dumpKernel()
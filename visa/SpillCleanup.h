@@ -53,9 +53,18 @@ namespace vISA
         const unsigned int cSpillFillCleanupWindowSize = 10;
         const unsigned int cFillWindowThreshold128GRF = 180;
         const unsigned int cSpillWindowThreshold128GRF = 120;
+        // Max pressure in a loop for fill hoisting/spill sinking to be allowed.
+        // Moved fills/spills extend live-ranges of temps that cannot be spilled
+        // so this is kept well below the GRF budget.
+        const unsigned int cLoopPlacementThreshold128GRF = 96;
 
         unsigned int fillWindowSizeThreshold = 0;
         unsigned int spillWindowSizeThreshold = 0;
+        unsigned int loopPlacementThreshold = 0;
+
+        // Estimated increase in register pressure per BB due to
+        // fills hoisted out of/spills sunk out of loops.
+        std::map<G4_BB*, unsigned int> placementPressure;
 
         // <Old fill declare*, std::pair<Coalesced Decl*, Row Off>>
         // This data structure is used to replaced old spill/fill operands
@@ -100,6 +109,16 @@ namespace vISA
         void spillFillCleanup();
         void removeRedundantWrites();
         void computeAddressTakenDcls();
+        unsigned int getNumScratchMsgs();
+        std::vector<G4_BB*> getLoopBBsInLayoutOrder(const FlowGraph::Blocks&);
+        unsigned int getLoopPressure(const FlowGraph::Blocks&);
+        bool dominatesExits(const FlowGraph::Blocks&, G4_BB*, G4_BB*, const std::set<G4_BB*>&);
+        void hoistLoopFills(const FlowGraph::Blocks&, G4_BB*,
+            std::unordered_map<G4_Declare*, unsigned int>&);
+        void sinkLoopSpills(const FlowGraph::Blocks&, G4_BB*,
+            std::unordered_map<G4_Declare*, unsigned int>&);
+        void moveFillsToFallThroughPred();
+        void spillFillPlacement();
 
     public:
         CoalesceSpillFills(G4_Kernel& k, LivenessAnalysis& l, GraphColor& g,
@@ -109,6 +128,7 @@ namespace vISA
             unsigned int numGRFs = k.getOptions()->getuInt32Option(vISA_TotalGRFNum);
             fillWindowSizeThreshold = numGRFs - (128 - cFillWindowThreshold128GRF);
             spillWindowSizeThreshold = numGRFs - (128 - cSpillWindowThreshold128GRF);
+            loopPlacementThreshold = numGRFs - (128 - cLoopPlacementThreshold128GRF);
 
             iterationNo = iterNo;
 
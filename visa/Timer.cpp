@@ -210,6 +210,24 @@ void stopTimer(int timer)
 #endif
 }
 
+void saveTimers(TimerSnapshot& snapshot)
+{
+    for (int i = 0; i < TIMER_NUM_TIMERS; i++)
+    {
+        snapshot.time[i] = timers[i].time;
+        snapshot.ticks[i] = timers[i].ticks;
+    }
+}
+
+void addTimers(const TimerSnapshot& snapshot)
+{
+    for (int i = 0; i < TIMER_NUM_TIMERS; i++)
+    {
+        timers[i].time += snapshot.time[i];
+        timers[i].ticks += snapshot.ticks[i];
+    }
+}
+
 extern "C" unsigned int getTotalTimers()
 {
     return numTimers;
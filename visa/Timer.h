@@ -66,5 +66,17 @@ typedef enum TIMERS
 } TIMERS;
 #undef DEF_TIMER
 
+// Timers are kept per thread. A thread that compiles on behalf of another
+// one saves its timers when it is done, and the owning thread adds them to
+// its own.
+struct TimerSnapshot
+{
+    double time[TIMER_NUM_TIMERS];
+    LONGLONG ticks[TIMER_NUM_TIMERS];
+};
+
+void saveTimers(TimerSnapshot& snapshot);
+void addTimers(const TimerSnapshot& snapshot);
+
 #endif
 
@@ -669,6 +669,7 @@ public:
     CM_BUILDER_API virtual int GetGenxDebugInfo(void *&buffer, unsigned int &size, void*&, unsigned int&);
     CM_BUILDER_API int GetGenReloc(BasicRelocEntry*& relocs, unsigned int& numRelocs);
     CM_BUILDER_API int GetFreeGRFInfo(void*& buffer, unsigned int& size);
+    CM_BUILDER_API int DumpG4IR(const char *fileName);
 
     CM_BUILDER_API int GetFunctionId(unsigned int& id);
 
@@ -750,6 +751,10 @@ public:
     std::string getAsmName() { return m_asmName; }
 
     int compileFastPath();
+    // compileFastPath() in two steps. Building the flow graph still uses the
+    // builder's state; optimization and RA only touch this compilation unit.
+    int compileFastPathBuildCFG();
+    int compileFastPathOptimize();
 
     unsigned int m_magic_number;
     unsigned char m_major_version;
@@ -885,7 +890,6 @@ private:
     int InitializeFastPath();
     int predefinedVarRegAssignment();
     int calculateTotalInputSize();
-    int compileTillOptimize();
     void getHeightWidth(G4_Type type, unsigned int numberElements, unsigned short &dclWidth, unsigned short &dclHeight, int &totalByteSize);
     CisaFramework::CisaInst* AppendVISASvmGeneralScatterInst(VISA_PredOpnd* pred,
         Common_VISA_EMask_Ctrl emask, Common_ISA_Exec_Size execSize, unsigned char blockSize,
@@ -123,6 +123,18 @@ int VISAKernelImpl::calculateTotalInputSize()
 }
 
 int VISAKernelImpl::compileFastPath()
+{
+    int status = compileFastPathBuildCFG();
+
+    if(status != CM_SUCCESS)
+    {
+        return status;
+    }
+
+    return compileFastPathOptimize();
+}
+
+int VISAKernelImpl::compileFastPathBuildCFG()
 {
     int status = CM_SUCCESS;
 
@@ -145,11 +157,24 @@ int VISAKernelImpl::compileFastPath()
 
     kernel.setNumRegTotal(builder.getOptions()->getuInt32Option(vISA_TotalGRFNum));
 
-    status = compileTillOptimize();
+    startTimer(TIMER_CFG);
+    kernel.fg.constructFlowGraph(builder.instList);
+    stopTimer(TIMER_CFG);
 
     return status;
 }
 
+int VISAKernelImpl::compileFastPathOptimize()
+{
+    // For separate compilation run compilation till RA then return
+
+    // move the options into the function, like LIR
+
+    Optimizer optimizer(*m_kernelMem, *m_builder, *m_kernel, m_kernel->fg);
+
+    return optimizer.optimization();
+}
+
 void replaceFCOpcodes(IR_Builder& builder)
 {
     BB_LIST_ITER bbEnd = builder.kernel.fg.BBs.end();
@@ -194,20 +219,6 @@ static void setDeclAlignment(G4_Declare* dcl, VISA_Align align)
     }
 }
 
-int VISAKernelImpl::compileTillOptimize()
-{
-    // For separate compilation run compilation till RA then return
-    startTimer(TIMER_CFG);
-    m_kernel->fg.constructFlowGraph(m_builder->instList);
-    stopTimer(TIMER_CFG);
-
-    // move the options into the function, like LIR
-
-    Optimizer optimizer(*m_kernelMem, *m_builder, *m_kernel, m_kernel->fg);
-
-    return optimizer.optimization();
-}
-
 void* VISAKernelImpl::compilePostOptimize(unsigned int& binarySize)
 {
     void* binary = NULL;
@@ -8146,6 +8157,23 @@ int VISAKernelImpl::GetFreeGRFInfo(void*& buffer, unsigned int& size)
     return CM_SUCCESS;
 }
 
+int VISAKernelImpl::DumpG4IR(const char *fileName)
+{
+    if (fileName == NULL || m_kernel == NULL)
+    {
+        return CM_FAILURE;
+    }
+
+    std::ofstream ofile(fileName, std::ios::out);
+    if (!ofile)
+    {
+        return CM_FAILURE;
+    }
+    m_kernel->emitG4IR(ofile);
+    ofile.close();
+    return CM_SUCCESS;
+}
+
 // index
 VISA_opnd* VISAKernelImpl::CreateOtherOpnd(unsigned int value, VISA_Type opndType)
 {
@@ -152,6 +152,12 @@ int SetStepping( const char * str ) {
     return retVal;
 }
 
+// same as previous version, except that we already have the enum value
+void SetVisaStepping( Stepping s )
+{
+    stepping = s;
+}
+
 Stepping GetStepping( void )
 {
     return stepping;
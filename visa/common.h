@@ -173,6 +173,7 @@ extern "C" int getGenxPlatformEncoding();
 
 extern "C" void InitStepping();
 extern "C" int SetStepping( const char* s);
+extern "C" void SetVisaStepping( Stepping s );
 extern "C" Stepping GetStepping( void );
 extern "C" const char * GetSteppingString( void );
 
@@ -770,6 +770,11 @@ public:
     /// This requires reRA pass to be executed, otherwise it returs nullptr
     CM_BUILDER_API virtual int GetFreeGRFInfo(void *& buffer, unsigned int& size) = 0;
 
+    /// DumpG4IR -- writes the current G4 IR of this kernel as text to <fileName>.
+    /// Unlike the vISA dumps this does not need a CM_CISA_BUILDER_BOTH builder,
+    /// so it can be used to dump a kernel after a failed Compile().
+    CM_BUILDER_API virtual int DumpG4IR(const char *fileName) = 0;
+
     ///Gets declaration id GenVar
     CM_BUILDER_API virtual int getDeclarationID(VISA_GenVar *decl) = 0;
 